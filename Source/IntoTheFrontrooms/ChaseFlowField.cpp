@@ -0,0 +1,233 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ChaseFlowField.h"
+#include "NavigationData.h"
+
+namespace ChaseFlowField
+{
+	// Neighbour offsets, direction D and (D + 4) % 8 are opposite
+	static const FIntPoint Offsets[8] =
+	{
+		FIntPoint(1, 0), FIntPoint(1, 1), FIntPoint(0, 1), FIntPoint(-1, 1),
+		FIntPoint(-1, 0), FIntPoint(-1, -1), FIntPoint(0, -1), FIntPoint(1, -1)
+	};
+
+	static const float StepCosts[8] =
+	{
+		1.0f, UE_SQRT_2, 1.0f, UE_SQRT_2, 1.0f, UE_SQRT_2, 1.0f, UE_SQRT_2
+	};
+
+	struct FOpenCell
+	{
+		float Cost;
+		int32 Cell;
+
+		bool operator<(const FOpenCell& Other) const { return Cost < Other.Cost; }
+	};
+}
+
+void FChaseFlowField::BeginBuild(const FVector& InCenter, float InRadius, float InCellSize, float InMaxStepHeight, float InVerticalExtent)
+{
+	Center = InCenter;
+	Radius = InRadius;
+	CellSize = FMath::Max(InCellSize, 10.0f);
+	MaxStepHeight = InMaxStepHeight;
+	VerticalExtent = InVerticalExtent;
+
+	Dim = FMath::Max(1, FMath::CeilToInt32(2.0f * Radius / CellSize));
+	Origin = FVector2D(Center.X, Center.Y) - FVector2D(0.5f * Dim * CellSize);
+
+	const int32 NumCells = Dim * Dim;
+	Heights.SetNumUninitialized(NumCells);
+	Walkable.Init(false, NumCells);
+	Links.SetNumZeroed(NumCells);
+	Distances.Init(MAX_FLT, NumCells);
+	NextDirections.Init(INDEX_NONE, NumCells);
+
+	GoalCell = INDEX_NONE;
+	BuildCursor = 0;
+	Stage = EStage::Project;
+}
+
+void FChaseFlowField::Reset()
+{
+	Heights.Reset();
+	Walkable.Reset();
+	Links.Reset();
+	Distances.Reset();
+	NextDirections.Reset();
+	Dim = 0;
+	GoalCell = INDEX_NONE;
+	BuildCursor = 0;
+	Stage = EStage::None;
+}
+
+FVector FChaseFlowField::GetCellLocation(int32 Cell) const
+{
+	return FVector(
+		Origin.X + (Cell % Dim + 0.5f) * CellSize,
+		Origin.Y + (Cell / Dim + 0.5f) * CellSize,
+		Heights[Cell]);
+}
+
+int32 FChaseFlowField::GetCellIndex(const FVector& Location) const
+{
+	if (Dim == 0)
+		return INDEX_NONE;
+
+	const int32 X = FMath::FloorToInt32((Location.X - Origin.X) / CellSize);
+	const int32 Y = FMath::FloorToInt32((Location.Y - Origin.Y) / CellSize);
+	if (X < 0 || Y < 0 || X >= Dim || Y >= Dim)
+		return INDEX_NONE;
+
+	return Y * Dim + X;
+}
+
+bool FChaseFlowField::ContinueBuild(const ANavigationData& NavData, int32& CellBudget)
+{
+	using namespace ChaseFlowField;
+
+	const int32 NumCells = Dim * Dim;
+
+	if (Stage == EStage::Project)
+	{
+		const FVector Extent(0.5f * CellSize, 0.5f * CellSize, VerticalExtent);
+		for (; BuildCursor < NumCells && CellBudget > 0; ++BuildCursor, --CellBudget)
+		{
+			const FVector CellCenter(
+				Origin.X + (BuildCursor % Dim + 0.5f) * CellSize,
+				Origin.Y + (BuildCursor / Dim + 0.5f) * CellSize,
+				Center.Z);
+
+			FNavLocation Projected;
+			if (NavData.ProjectPoint(CellCenter, Projected, Extent))
+			{
+				Heights[BuildCursor] = Projected.Location.Z;
+				Walkable[BuildCursor] = true;
+			}
+		}
+
+		if (BuildCursor < NumCells)
+			return false;
+
+		BuildCursor = 0;
+		Stage = EStage::Link;
+	}
+
+	if (Stage == EStage::Link)
+	{
+		for (; BuildCursor < NumCells && CellBudget > 0; ++BuildCursor, --CellBudget)
+		{
+			if (!Walkable[BuildCursor])
+				continue;
+
+			const FIntPoint Cell(BuildCursor % Dim, BuildCursor / Dim);
+			const FVector From = GetCellLocation(BuildCursor);
+
+			// Each link is tested once from its lower-direction side and stored on both cells
+			for (int32 Direction = 0; Direction < 4; ++Direction)
+			{
+				const FIntPoint Next = Cell + Offsets[Direction];
+				if (Next.X < 0 || Next.Y < 0 || Next.X >= Dim || Next.Y >= Dim)
+					continue;
+
+				const int32 NextCell = Next.Y * Dim + Next.X;
+				if (!Walkable[NextCell] || FMath::Abs(Heights[NextCell] - Heights[BuildCursor]) > MaxStepHeight)
+					continue;
+
+				FVector HitLocation;
+				if (NavData.Raycast(From, GetCellLocation(NextCell), HitLocation, nullptr))
+					continue; // Wall or navmesh edge in between
+
+				Links[BuildCursor] |= 1 << Direction;
+				Links[NextCell] |= 1 << ((Direction + 4) % 8);
+			}
+		}
+
+		if (BuildCursor < NumCells)
+			return false;
+
+		Stage = EStage::Built;
+	}
+
+	return Stage == EStage::Built;
+}
+
+bool FChaseFlowField::Integrate(const FVector& Goal)
+{
+	using namespace ChaseFlowField;
+
+	if (!IsBuilt())
+		return false;
+
+	const int32 NewGoalCell = GetCellIndex(Goal);
+	if (NewGoalCell == INDEX_NONE || !Walkable[NewGoalCell])
+	{
+		GoalCell = INDEX_NONE;
+		return false;
+	}
+
+	GoalCell = NewGoalCell;
+	for (float& Distance : Distances)
+	{
+		Distance = MAX_FLT;
+	}
+	for (int8& NextDirection : NextDirections)
+	{
+		NextDirection = INDEX_NONE;
+	}
+
+	// Dijkstra outward from the goal, every relaxed cell remembers which neighbour leads back
+	TArray<FOpenCell, TInlineAllocator<256>> Open;
+	Distances[GoalCell] = 0.0f;
+	Open.HeapPush({ 0.0f, GoalCell });
+
+	while (Open.Num() > 0)
+	{
+		FOpenCell Current;
+		Open.HeapPop(Current, EAllowShrinking::No);
+		if (Current.Cost > Distances[Current.Cell])
+			continue; // Stale entry
+
+		const FIntPoint Cell(Current.Cell % Dim, Current.Cell / Dim);
+		const uint8 CellLinks = Links[Current.Cell];
+		for (int32 Direction = 0; Direction < 8; ++Direction)
+		{
+			if (!(CellLinks & (1 << Direction)))
+				continue;
+
+			const FIntPoint Next = Cell + Offsets[Direction];
+			const int32 NextCell = Next.Y * Dim + Next.X;
+			const float NewCost = Current.Cost + StepCosts[Direction];
+			if (NewCost < Distances[NextCell])
+			{
+				Distances[NextCell] = NewCost;
+				NextDirections[NextCell] = (Direction + 4) % 8;
+				Open.HeapPush({ NewCost, NextCell });
+			}
+		}
+	}
+
+	return true;
+}
+
+bool FChaseFlowField::GetMoveDirection(const FVector& Location, FVector& OutDirection) const
+{
+	using namespace ChaseFlowField;
+
+	if (!IsBuilt() || GoalCell == INDEX_NONE)
+		return false;
+
+	const int32 Cell = GetCellIndex(Location);
+	if (Cell == INDEX_NONE || NextDirections[Cell] == INDEX_NONE)
+		return false;
+
+	// Ignore cells on another floor than the one the chaser stands on
+	if (FMath::Abs(Location.Z - Heights[Cell]) > VerticalExtent)
+		return false;
+
+	const FIntPoint Next = FIntPoint(Cell % Dim, Cell / Dim) + Offsets[NextDirections[Cell]];
+	const FVector ToNext = GetCellLocation(Next.Y * Dim + Next.X) - Location;
+	OutDirection = FVector(ToNext.X, ToNext.Y, 0.0f).GetSafeNormal();
+	return !OutDirection.IsNearlyZero();
+}
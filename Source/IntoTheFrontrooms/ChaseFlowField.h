@@ -0,0 +1,85 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class ANavigationData;
+
+/**
+ * Navmesh-backed distance field toward one goal (a chased player), shared by every chaser of that goal.
+ * Cells of a square grid are projected onto the navmesh and linked to their neighbours with navmesh raycasts,
+ * then a Dijkstra pass from the goal cell stores the next cell to step into for every reachable cell.
+ * Usage: BeginBuild(), ContinueBuild() over several frames until it returns true, then Integrate() whenever
+ * the goal changes cell and GetMoveDirection() per chaser.
+ */
+class INTOTHEFRONTROOMS_API FChaseFlowField
+{
+public:
+	/** Start a new build of Radius around Center, replaces any previous field */
+	void BeginBuild(const FVector& Center, float Radius, float InCellSize, float InMaxStepHeight, float InVerticalExtent);
+
+	/** Project and link up to CellBudget cells, decrementing it. Returns true once the field is built. */
+	bool ContinueBuild(const ANavigationData& NavData, int32& CellBudget);
+
+	/** Drop the field */
+	void Reset();
+
+	bool IsBuilt() const { return Stage == EStage::Built; }
+	bool IsBuilding() const { return Stage == EStage::Project || Stage == EStage::Link; }
+
+	const FVector& GetCenter() const { return Center; }
+	float GetRadius() const { return Radius; }
+
+	/** Cell containing Location (XY only), INDEX_NONE if outside the field */
+	int32 GetCellIndex(const FVector& Location) const;
+
+	/** Cell the field currently leads to, INDEX_NONE before the first Integrate() */
+	int32 GetGoalCell() const { return GoalCell; }
+
+	/** Recompute distances toward Goal. Returns false if Goal is not on a walkable cell. */
+	bool Integrate(const FVector& Goal);
+
+	/** Horizontal direction to follow from Location. False if Location is off the field,
+	 *  cannot reach the goal or is already in the goal cell. */
+	bool GetMoveDirection(const FVector& Location, FVector& OutDirection) const;
+
+private:
+	enum class EStage : uint8
+	{
+		None,
+		Project,	// Projecting cell centers onto the navmesh
+		Link,		// Raycasting between neighbouring cells
+		Built
+	};
+
+	FVector GetCellLocation(int32 Cell) const;
+
+	FVector Center = FVector::ZeroVector;
+	float Radius = 0.0f;
+	float CellSize = 100.0f;
+	float MaxStepHeight = 50.0f;
+	float VerticalExtent = 250.0f;
+
+	// Min XY corner of the grid
+	FVector2D Origin = FVector2D::ZeroVector;
+	int32 Dim = 0;
+
+	EStage Stage = EStage::None;
+	int32 BuildCursor = 0;
+
+	// Navmesh height per cell, only meaningful where Walkable is set
+	TArray<float> Heights;
+	TBitArray<> Walkable;
+
+	// One bit per neighbour direction that can be walked to directly
+	TArray<uint8> Links;
+
+	// Path distance to the goal cell, MAX_FLT if unreachable
+	TArray<float> Distances;
+
+	// Neighbour direction to step into toward the goal, INDEX_NONE for the goal and unreachable cells
+	TArray<int8> NextDirections;
+
+	int32 GoalCell = INDEX_NONE;
+};
@@ -0,0 +1,238 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "EffectPoolSubsystem.h"
+#include "NiagaraComponent.h"
+#include "NiagaraSystem.h"
+#include "Particles/ParticleSystem.h"
+#include "Particles/ParticleSystemComponent.h"
+#include "Kismet/GameplayStatics.h"
+#include "Sound/SoundBase.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/World.h"
+
+UEffectPoolSubsystem::UEffectPoolSubsystem()
+{
+	DefaultPrewarmCount = 4;
+	MaxConcurrentPerEffect = 8;
+	CullDistance = 8000.0f;
+	DefaultMaxLifetime = 10.0f;
+}
+
+bool UEffectPoolSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UEffectPoolSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UEffectPoolSubsystem, STATGROUP_Tickables);
+}
+
+void UEffectPoolSubsystem::Deinitialize()
+{
+	for (TPair<TObjectPtr<UFXSystemAsset>, FEffectPool>& Pair : Pools)
+	{
+		for (UFXSystemComponent* Component : Pair.Value.Free)
+		{
+			if (IsValid(Component))
+			{
+				Component->DestroyComponent();
+			}
+		}
+	}
+	for (const FActiveEffect& Active : ActiveEffects)
+	{
+		if (IsValid(Active.Component))
+		{
+			Active.Component->DestroyComponent();
+		}
+	}
+	Pools.Empty();
+	ActiveEffects.Empty();
+
+	Super::Deinitialize();
+}
+
+UFXSystemComponent* UEffectPoolSubsystem::CreateComponent(UFXSystemAsset* Asset)
+{
+	UWorld* World = GetWorld();
+	UFXSystemComponent* Component = nullptr;
+
+	// The finished event is bound once here, it returns the component on every reuse
+	if (UNiagaraSystem* NiagaraSystem = Cast<UNiagaraSystem>(Asset))
+	{
+		UNiagaraComponent* NiagaraComponent = NewObject<UNiagaraComponent>(World);
+		NiagaraComponent->SetAutoActivate(false);
+		NiagaraComponent->SetAutoDestroy(false);
+		NiagaraComponent->SetAsset(NiagaraSystem);
+		NiagaraComponent->OnSystemFinished.AddDynamic(this, &UEffectPoolSubsystem::OnNiagaraFinished);
+		Component = NiagaraComponent;
+	}
+	else if (UParticleSystem* ParticleSystem = Cast<UParticleSystem>(Asset))
+	{
+		UParticleSystemComponent* ParticleComponent = NewObject<UParticleSystemComponent>(World);
+		ParticleComponent->bAutoActivate = false;
+		ParticleComponent->bAutoDestroy = false;
+		ParticleComponent->SetTemplate(ParticleSystem);
+		ParticleComponent->OnSystemFinished.AddDynamic(this, &UEffectPoolSubsystem::OnCascadeFinished);
+		Component = ParticleComponent;
+	}
+
+	if (Component)
+	{
+		Component->RegisterComponentWithWorld(World);
+	}
+	return Component;
+}
+
+void UEffectPoolSubsystem::Prewarm(UFXSystemAsset* Asset, int32 Count)
+{
+	// Nothing is ever shown on a dedicated server
+	if (!Asset || IsRunningDedicatedServer())
+		return;
+
+	if (Count < 0)
+	{
+		Count = DefaultPrewarmCount;
+	}
+
+	FEffectPool& Pool = Pools.FindOrAdd(Asset);
+	while (Pool.Free.Num() + Pool.NumActive < Count)
+	{
+		UFXSystemComponent* Component = CreateComponent(Asset);
+		if (!Component)
+			break;
+
+		Pool.Free.Add(Component);
+	}
+}
+
+bool UEffectPoolSubsystem::IsNearLocalPlayer(const FVector& Location, float Distance) const
+{
+	const float DistanceSq = FMath::Square(Distance);
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		APlayerController* PC = It->Get();
+		if (!PC || !PC->IsLocalController())
+			continue;
+
+		FVector ViewLocation;
+		FRotator ViewRotation;
+		PC->GetPlayerViewPoint(ViewLocation, ViewRotation);
+		if (FVector::DistSquared(ViewLocation, Location) <= DistanceSq)
+			return true;
+	}
+	return false;
+}
+
+UFXSystemComponent* UEffectPoolSubsystem::SpawnEffectAtLocation(UFXSystemAsset* Asset, const FVector& Location, const FRotator& Rotation, FVector Scale, float Lifetime)
+{
+	if (!Asset)
+		return nullptr;
+
+	if (CullDistance > 0.0f ? !IsNearLocalPlayer(Location, CullDistance) : IsRunningDedicatedServer())
+	{
+		++Stats.Culled;
+		return nullptr;
+	}
+
+	FEffectPool& Pool = Pools.FindOrAdd(Asset);
+	if (Pool.NumActive >= MaxConcurrentPerEffect)
+	{
+		++Stats.Capped;
+		return nullptr;
+	}
+
+	UFXSystemComponent* Component = nullptr;
+	while (!Component && Pool.Free.Num() > 0)
+	{
+		Component = Pool.Free.Pop(EAllowShrinking::No);
+		if (!IsValid(Component))
+		{
+			Component = nullptr;
+		}
+	}
+
+	if (!Component)
+	{
+		++Stats.PoolMisses;
+		Component = CreateComponent(Asset);
+		if (!Component)
+			return nullptr;
+	}
+
+	Component->SetWorldLocationAndRotation(Location, Rotation);
+	Component->SetWorldScale3D(Scale);
+	Component->Activate(true); // Reset restarts the system from the beginning
+
+	++Pool.NumActive;
+	++Stats.Spawned;
+
+	FActiveEffect& Active = ActiveEffects.AddDefaulted_GetRef();
+	Active.Component = Component;
+	Active.Asset = Asset;
+	Active.ExpireTime = GetWorld()->GetTimeSeconds() + (Lifetime > 0.0f ? Lifetime : DefaultMaxLifetime);
+
+	return Component;
+}
+
+void UEffectPoolSubsystem::PlaySoundAtLocation(USoundBase* Sound, const FVector& Location, float VolumeMultiplier, float PitchMultiplier)
+{
+	if (!Sound || !IsNearLocalPlayer(Location, Sound->GetMaxDistance()))
+		return;
+
+	// One-shot sounds play as active sounds without an audio component
+	UGameplayStatics::PlaySoundAtLocation(GetWorld(), Sound, Location, VolumeMultiplier, PitchMultiplier);
+}
+
+void UEffectPoolSubsystem::Tick(float DeltaTime)
+{
+	if (ActiveEffects.Num() == 0)
+		return;
+
+	// Stop effects that outlived their lifetime (looping or never-finishing systems)
+	const double Now = GetWorld()->GetTimeSeconds();
+	for (int32 Index = ActiveEffects.Num() - 1; Index >= 0; --Index)
+	{
+		if (!ActiveEffects.IsValidIndex(Index) || ActiveEffects[Index].ExpireTime > Now)
+			continue;
+
+		// Deactivating may fire the finished event, which returns the component itself
+		UFXSystemComponent* Component = ActiveEffects[Index].Component;
+		if (IsValid(Component))
+		{
+			Component->DeactivateImmediate();
+		}
+		ReturnComponent(Component);
+	}
+}
+
+void UEffectPoolSubsystem::ReturnComponent(UFXSystemComponent* Component)
+{
+	const int32 Index = ActiveEffects.IndexOfByPredicate([Component](const FActiveEffect& Active)
+	{
+		return Active.Component == Component;
+	});
+	if (Index == INDEX_NONE)
+		return;
+
+	if (FEffectPool* Pool = Pools.Find(ActiveEffects[Index].Asset))
+	{
+		Pool->NumActive = FMath::Max(Pool->NumActive - 1, 0);
+		if (IsValid(Component))
+		{
+			Pool->Free.Add(Component);
+		}
+	}
+	ActiveEffects.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+}
+
+void UEffectPoolSubsystem::OnNiagaraFinished(UNiagaraComponent* Component)
+{
+	ReturnComponent(Component);
+}
+
+void UEffectPoolSubsystem::OnCascadeFinished(UParticleSystemComponent* Component)
+{
+	ReturnComponent(Component);
+}
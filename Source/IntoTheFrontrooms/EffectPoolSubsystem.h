@@ -0,0 +1,147 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "EffectPoolSubsystem.generated.h"
+
+class UFXSystemAsset;
+class UFXSystemComponent;
+class UNiagaraComponent;
+class UParticleSystemComponent;
+class USoundBase;
+
+/** Idle components of one effect asset */
+USTRUCT()
+struct FEffectPool
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<TObjectPtr<UFXSystemComponent>> Free;
+
+	// Components of this asset currently playing
+	int32 NumActive = 0;
+};
+
+/** A pooled component that is playing */
+USTRUCT()
+struct FActiveEffect
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TObjectPtr<UFXSystemComponent> Component;
+
+	UPROPERTY()
+	TObjectPtr<UFXSystemAsset> Asset;
+
+	// World time the component is stopped and returned if it has not finished on its own
+	double ExpireTime = 0.0;
+};
+
+/** Effect spawn counters */
+USTRUCT(BlueprintType)
+struct FEffectPoolStats
+{
+	GENERATED_BODY()
+
+	/** Effects started */
+	UPROPERTY(BlueprintReadOnly, Category = "Effects")
+	int32 Spawned = 0;
+
+	/** Spawns skipped because no local player was within CullDistance */
+	UPROPERTY(BlueprintReadOnly, Category = "Effects")
+	int32 Culled = 0;
+
+	/** Spawns skipped because the asset already had MaxConcurrentPerEffect playing */
+	UPROPERTY(BlueprintReadOnly, Category = "Effects")
+	int32 Capped = 0;
+
+	/** Spawns that found the pool empty and had to create a component */
+	UPROPERTY(BlueprintReadOnly, Category = "Effects")
+	int32 PoolMisses = 0;
+};
+
+/**
+ * Pooled one-shot Niagara/Cascade effects and fire-and-forget sounds.
+ * Components are created ahead of time per effect asset, reset and reused on every spawn
+ * and returned to their pool from their own finished event, so spawning an effect during
+ * combat allocates neither components nor timer delegates. Spawns are skipped beyond
+ * CullDistance from every local player (always on a dedicated server) and once an asset
+ * has MaxConcurrentPerEffect instances playing.
+ */
+UCLASS(config=Game)
+class INTOTHEFRONTROOMS_API UEffectPoolSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UEffectPoolSubsystem();
+
+	// USubsystem interface
+	virtual void Deinitialize() override;
+
+	// FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/** Make sure the pool of Asset holds at least Count components (DefaultPrewarmCount when Count < 0) */
+	UFUNCTION(BlueprintCallable, Category = "Effects")
+	void Prewarm(UFXSystemAsset* Asset, int32 Count = -1);
+
+	/** Play a pooled one-shot effect. Lifetime caps how long it may play, 0 uses DefaultMaxLifetime. Null if culled or capped. */
+	UFUNCTION(BlueprintCallable, Category = "Effects")
+	UFXSystemComponent* SpawnEffectAtLocation(UFXSystemAsset* Asset, const FVector& Location, const FRotator& Rotation, FVector Scale = FVector(1.0f, 1.0f, 1.0f), float Lifetime = 0.0f);
+
+	/** Play a sound without a component, skipped when every listener is beyond the sound's max distance */
+	UFUNCTION(BlueprintCallable, Category = "Effects")
+	void PlaySoundAtLocation(USoundBase* Sound, const FVector& Location, float VolumeMultiplier = 1.0f, float PitchMultiplier = 1.0f);
+
+	/** Spawn counters since the world started */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Effects")
+	FEffectPoolStats GetStats() const { return Stats; }
+
+	/** Components created per asset when prewarmed without a count */
+	UPROPERTY(Config, BlueprintReadOnly, Category = "Effects")
+	int32 DefaultPrewarmCount;
+
+	/** Instances of one effect asset allowed to play at once */
+	UPROPERTY(Config, BlueprintReadOnly, Category = "Effects")
+	int32 MaxConcurrentPerEffect;
+
+	/** Effects farther than this from every local player are not spawned, 0 disables culling */
+	UPROPERTY(Config, BlueprintReadOnly, Category = "Effects")
+	float CullDistance;
+
+	/** Longest an effect may play before it is stopped and returned, for effects that never finish */
+	UPROPERTY(Config, BlueprintReadOnly, Category = "Effects")
+	float DefaultMaxLifetime;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	// New idle component for Asset, registered with the world
+	UFXSystemComponent* CreateComponent(UFXSystemAsset* Asset);
+
+	// True if a local player view is within Distance of Location
+	bool IsNearLocalPlayer(const FVector& Location, float Distance) const;
+
+	// Stop tracking a finished component and put it back in its pool
+	void ReturnComponent(UFXSystemComponent* Component);
+
+	UFUNCTION()
+	void OnNiagaraFinished(UNiagaraComponent* Component);
+
+	UFUNCTION()
+	void OnCascadeFinished(UParticleSystemComponent* Component);
+
+	UPROPERTY()
+	TMap<TObjectPtr<UFXSystemAsset>, FEffectPool> Pools;
+
+	UPROPERTY()
+	TArray<FActiveEffect> ActiveEffects;
+
+	FEffectPoolStats Stats;
+};
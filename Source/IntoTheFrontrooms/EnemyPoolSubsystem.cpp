@@ -0,0 +1,147 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "EnemyPoolSubsystem.h"
+#include "RoamingAICharacter.h"
+#include "Engine/World.h"
+
+UEnemyPoolSubsystem::UEnemyPoolSubsystem()
+{
+	PrewarmCount = 0;
+	bGrowOnMiss = true;
+}
+
+bool UEnemyPoolSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UEnemyPoolSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// Enemies are spawned by the server and replicated
+	if (InWorld.GetNetMode() == NM_Client || PrewarmCount <= 0 || DefaultEnemyClass.IsNull())
+		return;
+
+	Prewarm(DefaultEnemyClass.LoadSynchronous(), PrewarmCount);
+}
+
+void UEnemyPoolSubsystem::Prewarm(TSubclassOf<ARoamingAICharacter> EnemyClass, int32 Count)
+{
+	if (!EnemyClass)
+		return;
+
+	FEnemyPool& Pool = Pools.FindOrAdd(EnemyClass);
+	Pool.Available.Reserve(Pool.Available.Num() + Count);
+	for (int32 Index = 0; Index < Count; ++Index)
+	{
+		if (ARoamingAICharacter* Enemy = CreatePooledEnemy(EnemyClass))
+		{
+			Pool.Available.Add(Enemy);
+		}
+	}
+}
+
+ARoamingAICharacter* UEnemyPoolSubsystem::CreatePooledEnemy(TSubclassOf<ARoamingAICharacter> EnemyClass)
+{
+	// Hidden without collision, so where pooled enemies wait does not matter
+	const FTransform Transform = FTransform::Identity;
+	ARoamingAICharacter* Enemy = GetWorld()->SpawnActorDeferred<ARoamingAICharacter>(
+		EnemyClass, Transform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+	if (!Enemy)
+		return nullptr;
+
+	Enemy->InitializeForPool();
+	Enemy->bAllowProxyRepresentation = false; // Pooling and proxies both park the actor, keep them apart
+	Enemy->FinishSpawning(Transform);
+
+	++Stats.NumCreated;
+	return Enemy;
+}
+
+ARoamingAICharacter* UEnemyPoolSubsystem::AcquireEnemy(TSubclassOf<ARoamingAICharacter> EnemyClass, const FVector& Location, const FRotator& Rotation)
+{
+	if (!EnemyClass)
+		return nullptr;
+
+	++Stats.Acquires;
+	FEnemyPool& Pool = Pools.FindOrAdd(EnemyClass);
+
+	ARoamingAICharacter* Enemy = nullptr;
+	while (!Enemy && Pool.Available.Num() > 0)
+	{
+		Enemy = Pool.Available.Pop(EAllowShrinking::No);
+		if (!IsValid(Enemy))
+		{
+			Enemy = nullptr; // Destroyed while pooled, e.g. by level streaming
+		}
+	}
+
+	if (!Enemy)
+	{
+		++Stats.Misses;
+
+		// Drop enemies destroyed while handed out before the pool grows
+		NumActiveEntries -= Pool.Active.RemoveAllSwap([](const TObjectPtr<ARoamingAICharacter>& Active) { return !IsValid(Active); }, EAllowShrinking::No);
+
+		if (bGrowOnMiss)
+		{
+			Enemy = CreatePooledEnemy(EnemyClass);
+		}
+		if (!Enemy)
+		{
+			++Stats.FailedAcquires;
+			return nullptr;
+		}
+	}
+
+	Enemy->ActivateFromPool(Location, Rotation);
+	Pool.Active.Add(Enemy);
+	++NumActiveEntries;
+
+	Stats.PeakActive = FMath::Max(Stats.PeakActive, NumActiveEntries);
+	return Enemy;
+}
+
+void UEnemyPoolSubsystem::ReleaseEnemy(ARoamingAICharacter* Enemy)
+{
+	if (!IsValid(Enemy) || Enemy->IsInPool())
+		return;
+
+	FEnemyPool& Pool = Pools.FindOrAdd(Enemy->GetClass());
+	NumActiveEntries -= Pool.Active.RemoveSingleSwap(Enemy, EAllowShrinking::No);
+
+	Enemy->DeactivateForPool();
+	Pool.Available.Add(Enemy);
+	++Stats.Releases;
+}
+
+FEnemyPoolStats UEnemyPoolSubsystem::GetStats() const
+{
+	FEnemyPoolStats Result = Stats;
+	Result.NumActive = 0;
+	Result.NumAvailable = 0;
+
+	// Enemies destroyed while out (e.g. killed) are not counted
+	for (const TPair<TObjectPtr<UClass>, FEnemyPool>& Pair : Pools)
+	{
+		for (const ARoamingAICharacter* Enemy : Pair.Value.Active)
+		{
+			Result.NumActive += IsValid(Enemy) ? 1 : 0;
+		}
+		for (const ARoamingAICharacter* Enemy : Pair.Value.Available)
+		{
+			Result.NumAvailable += IsValid(Enemy) ? 1 : 0;
+		}
+	}
+	return Result;
+}
+
+void UEnemyPoolSubsystem::ResetStats()
+{
+	Stats.Acquires = 0;
+	Stats.Releases = 0;
+	Stats.Misses = 0;
+	Stats.FailedAcquires = 0;
+	Stats.PeakActive = GetStats().NumActive;
+}
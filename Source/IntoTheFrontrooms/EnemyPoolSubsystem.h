@@ -0,0 +1,129 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "EnemyPoolSubsystem.generated.h"
+
+class ARoamingAICharacter;
+
+/** Pooled enemies of one class */
+USTRUCT()
+struct FEnemyPool
+{
+	GENERATED_BODY()
+
+	// Deactivated enemies ready to be handed out
+	UPROPERTY()
+	TArray<TObjectPtr<ARoamingAICharacter>> Available;
+
+	// Enemies currently handed out
+	UPROPERTY()
+	TArray<TObjectPtr<ARoamingAICharacter>> Active;
+};
+
+/** Pool usage counters */
+USTRUCT(BlueprintType)
+struct FEnemyPoolStats
+{
+	GENERATED_BODY()
+
+	/** Enemies spawned by the pool, including ones grown on a miss */
+	UPROPERTY(BlueprintReadOnly, Category = "AI|Pool")
+	int32 NumCreated = 0;
+
+	/** Enemies currently handed out */
+	UPROPERTY(BlueprintReadOnly, Category = "AI|Pool")
+	int32 NumActive = 0;
+
+	/** Enemies waiting in the pool */
+	UPROPERTY(BlueprintReadOnly, Category = "AI|Pool")
+	int32 NumAvailable = 0;
+
+	/** Most enemies handed out at once */
+	UPROPERTY(BlueprintReadOnly, Category = "AI|Pool")
+	int32 PeakActive = 0;
+
+	/** Acquire calls */
+	UPROPERTY(BlueprintReadOnly, Category = "AI|Pool")
+	int32 Acquires = 0;
+
+	/** Release calls that returned an enemy to the pool */
+	UPROPERTY(BlueprintReadOnly, Category = "AI|Pool")
+	int32 Releases = 0;
+
+	/** Acquires that found the pool empty, each one spawns at runtime when growing is allowed */
+	UPROPERTY(BlueprintReadOnly, Category = "AI|Pool")
+	int32 Misses = 0;
+
+	/** Acquires that returned no enemy at all */
+	UPROPERTY(BlueprintReadOnly, Category = "AI|Pool")
+	int32 FailedAcquires = 0;
+};
+
+/**
+ * Keeps deactivated roaming enemies around so survival waves can change the enemy count
+ * without SpawnActor/Destroy hitches and GC churn. Enemies are created up front (see
+ * PrewarmCount), hidden with collision, movement, animation and AI off while pooled, and
+ * handed out with a fresh spawn location, attack cooldown and AI state.
+ * Server only, clients see pooled enemies through normal actor replication.
+ */
+UCLASS(config=Game)
+class INTOTHEFRONTROOMS_API UEnemyPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UEnemyPoolSubsystem();
+
+	// USubsystem interface
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	/** Spawn Count deactivated enemies of EnemyClass into the pool */
+	UFUNCTION(BlueprintCallable, Category = "AI|Pool")
+	void Prewarm(TSubclassOf<ARoamingAICharacter> EnemyClass, int32 Count);
+
+	/** Hand out a pooled enemy at Location. On a miss a new enemy is spawned if bGrowOnMiss, otherwise returns null. */
+	UFUNCTION(BlueprintCallable, Category = "AI|Pool")
+	ARoamingAICharacter* AcquireEnemy(TSubclassOf<ARoamingAICharacter> EnemyClass, const FVector& Location, const FRotator& Rotation);
+
+	/** Deactivate an enemy and return it to its class pool. Enemies placed in the level are adopted. */
+	UFUNCTION(BlueprintCallable, Category = "AI|Pool")
+	void ReleaseEnemy(ARoamingAICharacter* Enemy);
+
+	/** Current pool usage */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "AI|Pool")
+	FEnemyPoolStats GetStats() const;
+
+	/** Clear the acquire/release/miss counters, pool sizes are kept */
+	UFUNCTION(BlueprintCallable, Category = "AI|Pool")
+	void ResetStats();
+
+	/** Enemy class prewarmed at match start */
+	UPROPERTY(Config, BlueprintReadOnly, Category = "AI|Pool")
+	TSoftClassPtr<ARoamingAICharacter> DefaultEnemyClass;
+
+	/** Enemies of DefaultEnemyClass created at match start, 0 disables prewarming */
+	UPROPERTY(Config, BlueprintReadOnly, Category = "AI|Pool")
+	int32 PrewarmCount;
+
+	/** Spawn a new enemy when the pool is empty instead of failing the acquire */
+	UPROPERTY(Config, BlueprintReadOnly, Category = "AI|Pool")
+	bool bGrowOnMiss;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	// Spawn one deactivated enemy, null on failure
+	ARoamingAICharacter* CreatePooledEnemy(TSubclassOf<ARoamingAICharacter> EnemyClass);
+
+	UPROPERTY()
+	TMap<TObjectPtr<UClass>, FEnemyPool> Pools;
+
+	FEnemyPoolStats Stats;
+
+	// Entries in every pool's Active list, kept by acquire and release so the peak needs no walk over the pools.
+	// Includes enemies destroyed while handed out until a miss prunes them.
+	int32 NumActiveEntries = 0;
+};
@@ -17,8 +17,8 @@ void AHealthPackPickup::Pickup_Implementation(AIntoTheFrontroomsCharacter* Ownin
 		// The health logic is handled entirely in your Character Blueprint
 		UE_LOG(LogTemp, Log, TEXT("Health Pack: Player collected health pack (+%.0f HP)"), HealAmount);
 		
-		// Your Blueprint will handle the actual health increase via the "Health Increase" custom event
-		// which you'll need to create in your Character Blueprint
+		// Your Blueprint handles the actual health increase in the Character's OnHealthPackCollected event
+		OwningCharacter->OnHealthPackCollected(HealAmount);
 	}
 
 	// Call parent implementation to handle destruction, effects, etc.
@@ -19,7 +19,9 @@ public class IntoTheFrontrooms : ModuleRules
 			"SlateCore", 
 			"AIModule", 
 			"NavigationSystem",
-			"Niagara" // Added for particle effects (UE5)
+			"Niagara", // Added for particle effects (UE5)
+			"AnimationBudgetAllocator", // Enemy animation budgeting
+			"NetCore" // Push model replication
 		});
 	}
 }
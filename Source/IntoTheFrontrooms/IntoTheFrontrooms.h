@@ -3,3 +3,6 @@
 #pragma once
 
 #include "CoreMinimal.h"
+
+// Object channel of pickup spheres, see the Pickup collision profile
+#define ECC_Pickup ECC_GameTraceChannel2
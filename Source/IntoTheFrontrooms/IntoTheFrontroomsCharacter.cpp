@@ -9,6 +9,11 @@
 #include "EnhancedInputSubsystems.h"
 #include "InputActionValue.h"
 #include "Engine/LocalPlayer.h"
+#include "Engine/GameInstance.h"
+#include "NoteRegistrySubsystem.h"
+#include "IntoTheFrontroomsPickUpComponent.h"
+#include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
 
 DEFINE_LOG_CATEGORY(LogTemplateCharacter);
 
@@ -109,41 +114,159 @@ void AIntoTheFrontroomsCharacter::Look(const FInputActionValue& Value)
 	}
 }
 
+void AIntoTheFrontroomsCharacter::ClientNotifyPickedUp_Implementation(UIntoTheFrontroomsPickUpComponent* PickUpComponent)
+{
+	if (PickUpComponent != nullptr)
+	{
+		PickUpComponent->OnPickUp.Broadcast(this);
+	}
+}
+
 //////////////////////////////////////////////////////////////////////////// Note Collection System (ONLY NEW CODE)
 
-void AIntoTheFrontroomsCharacter::AddNote(FName NoteID, FText NoteTitle, FText NoteContent, UTexture2D* NoteImage)
+void AIntoTheFrontroomsCharacter::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	// A few bytes for the whole journal, replicated to everyone so a shared journal costs the same
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+	DOREPLIFETIME_WITH_PARAMS_FAST(AIntoTheFrontroomsCharacter, CollectedNoteBits, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(AIntoTheFrontroomsCharacter, CollectedRuntimeNoteIDs, Params);
+}
+
+void AIntoTheFrontroomsCharacter::AddNote(FName NoteID, FText NoteTitle, FText NoteContent, const TSoftObjectPtr<UTexture2D>& NoteImage)
+{
+	UNoteRegistrySubsystem* Registry = GetGameInstance() ? GetGameInstance()->GetSubsystem<UNoteRegistrySubsystem>() : nullptr;
+	if (!Registry)
+		return;
+
+	const int32 NoteIndex = Registry->RegisterNote(NoteID, NoteTitle, NoteContent, NoteImage);
+	if (NoteIndex == INDEX_NONE)
+		return;
+
 	// Check if note already collected
-	if (HasCollectedNote(NoteID))
+	const bool bStableIndex = Registry->HasStableIndex(NoteIndex);
+	if (bStableIndex ? IsNoteBitSet(NoteIndex) : CollectedRuntimeNoteIDs.Contains(NoteID))
 	{
 		UE_LOG(LogTemplateCharacter, Warning, TEXT("Note '%s' already collected!"), *NoteID.ToString());
 		return;
 	}
 
-	// Create note data
-	FCollectedNote NewNote;
-	NewNote.NoteID = NoteID;
-	NewNote.NoteTitle = NoteTitle;
-	NewNote.NoteContent = NoteContent;
-	NewNote.NoteImage = NoteImage;
-
-	// Add to array
-	CollectedNotes.Add(NewNote);
+	// Only database indices match on every machine, other notes replicate by ID
+	if (bStableIndex)
+	{
+		const int32 Word = NoteIndex / 32;
+		if (CollectedNoteBits.Num() <= Word)
+		{
+			CollectedNoteBits.SetNumZeroed(Word + 1);
+		}
+		CollectedNoteBits[Word] |= 1u << (NoteIndex % 32);
+		MARK_PROPERTY_DIRTY_FROM_NAME(AIntoTheFrontroomsCharacter, CollectedNoteBits, this);
+	}
+	else
+	{
+		CollectedRuntimeNoteIDs.Add(NoteID);
+		MARK_PROPERTY_DIRTY_FROM_NAME(AIntoTheFrontroomsCharacter, CollectedRuntimeNoteIDs, this);
+	}
 
 	UE_LOG(LogTemplateCharacter, Log, TEXT("Note collected: %s - %s"), *NoteID.ToString(), *NoteTitle.ToString());
 
-	// Fire Blueprint event for pause menu to handle
-	OnNoteCollected(NewNote);
+	AddToJournal(NoteIndex);
 }
 
-bool AIntoTheFrontroomsCharacter::HasCollectedNote(FName NoteID) const
+void AIntoTheFrontroomsCharacter::AddToJournal(int32 NoteIndex)
+{
+	UNoteRegistrySubsystem* Registry = GetGameInstance() ? GetGameInstance()->GetSubsystem<UNoteRegistrySubsystem>() : nullptr;
+	const FCollectedNote* Note = Registry ? Registry->GetNote(NoteIndex) : nullptr;
+	if (!Note)
+	{
+		UE_LOG(LogTemplateCharacter, Warning, TEXT("Collected note %d is not registered on this machine, add it to the note database"), NoteIndex);
+		return;
+	}
+
+	// Add to array, without content so images and long text don't stay resident
+	FCollectedNote& Entry = CollectedNotes.AddDefaulted_GetRef();
+	Entry.NoteID = Note->NoteID;
+	Entry.NoteTitle = Note->NoteTitle;
+
+	// Fire Blueprint event for pause menu to handle once the content is in
+	TWeakObjectPtr<AIntoTheFrontroomsCharacter> WeakThis(this);
+	Registry->LoadNoteContentByIndex(NoteIndex, [WeakThis](const FCollectedNote& LoadedNote)
+	{
+		if (AIntoTheFrontroomsCharacter* This = WeakThis.Get())
+		{
+			This->OnNoteCollected(LoadedNote);
+		}
+	});
+}
+
+void AIntoTheFrontroomsCharacter::OnRep_CollectedNoteBits(const TArray<uint32>& PreviousBits)
 {
-	for (const FCollectedNote& Note : CollectedNotes)
+	// Only bits that weren't set here before are new notes, their content comes from the registry
+	for (int32 Word = 0; Word < CollectedNoteBits.Num(); ++Word)
+	{
+		const uint32 NewBits = CollectedNoteBits[Word] & ~(PreviousBits.IsValidIndex(Word) ? PreviousBits[Word] : 0u);
+		if (NewBits == 0)
+			continue;
+
+		for (int32 Bit = 0; Bit < 32; ++Bit)
+		{
+			if ((NewBits & (1u << Bit)) == 0)
+				continue;
+
+			AddToJournal(Word * 32 + Bit);
+		}
+	}
+}
+
+void AIntoTheFrontroomsCharacter::OnRep_CollectedRuntimeNoteIDs(const TArray<FName>& PreviousIDs)
+{
+	UNoteRegistrySubsystem* Registry = GetGameInstance() ? GetGameInstance()->GetSubsystem<UNoteRegistrySubsystem>() : nullptr;
+	if (!Registry)
+		return;
+
+	// IDs are only ever appended, everything past the previous count is new
+	for (int32 Index = PreviousIDs.Num(); Index < CollectedRuntimeNoteIDs.Num(); ++Index)
 	{
-		if (Note.NoteID == NoteID)
+		const FName NoteID = CollectedRuntimeNoteIDs[Index];
+		int32 NoteIndex = Registry->FindNoteIndex(NoteID);
+		if (NoteIndex == INDEX_NONE)
 		{
-			return true;
+			// The pickup isn't loaded here, keep the ID so the journal still lists it
+			NoteIndex = Registry->RegisterNote(NoteID, FText::GetEmpty(), FText::GetEmpty(), nullptr);
 		}
+		AddToJournal(NoteIndex);
+	}
+}
+
+bool AIntoTheFrontroomsCharacter::IsNoteBitSet(int32 NoteIndex) const
+{
+	const int32 Word = NoteIndex / 32;
+	return NoteIndex >= 0 && CollectedNoteBits.IsValidIndex(Word) && (CollectedNoteBits[Word] & (1u << (NoteIndex % 32))) != 0;
+}
+
+bool AIntoTheFrontroomsCharacter::HasCollectedNote(FName NoteID) const
+{
+	const UNoteRegistrySubsystem* Registry = GetGameInstance() ? GetGameInstance()->GetSubsystem<UNoteRegistrySubsystem>() : nullptr;
+	if (!Registry)
+		return false;
+
+	const int32 NoteIndex = Registry->FindNoteIndex(NoteID);
+	return Registry->HasStableIndex(NoteIndex) ? IsNoteBitSet(NoteIndex) : CollectedRuntimeNoteIDs.Contains(NoteID);
+}
+
+int32 AIntoTheFrontroomsCharacter::GetCollectedNotesPage(int32 PageIndex, int32 PageSize, TArray<FCollectedNote>& OutNotes) const
+{
+	OutNotes.Reset();
+	if (PageSize <= 0)
+		return 0;
+
+	const int32 First = PageIndex * PageSize;
+	const int32 Last = FMath::Min(First + PageSize, CollectedNotes.Num());
+	for (int32 Index = FMath::Max(First, 0); Index < Last; ++Index)
+	{
+		OutNotes.Add(CollectedNotes[Index]);
 	}
-	return false;
+	return FMath::DivideAndRoundUp(CollectedNotes.Num(), PageSize);
 }
\ No newline at end of file
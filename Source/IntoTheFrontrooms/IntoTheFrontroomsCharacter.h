@@ -14,10 +14,12 @@ class UInputAction;
 class UInputMappingContext;
 struct FInputActionValue;
 class AIntoTheFrontroomsHUD;
+class UIntoTheFrontroomsPickUpComponent;
 
 DECLARE_LOG_CATEGORY_EXTERN(LogTemplateCharacter, Log, All);
 
-// Structure to hold note data
+// Structure to hold note data. Journal entries only carry ID and title, content and image are
+// filled in by UNoteRegistrySubsystem::LoadNoteContent.
 USTRUCT(BlueprintType)
 struct FCollectedNote
 {
@@ -86,6 +88,10 @@ public:
 	/** Returns FirstPersonCameraComponent subobject **/
 	UCameraComponent* GetFirstPersonCameraComponent() const { return FirstPersonCameraComponent; }
 
+	/** Pickups are detected on the server, this runs OnPickUp again on the owning client where local-only logic (e.g. weapon input) works */
+	UFUNCTION(Client, Reliable)
+	void ClientNotifyPickedUp(UIntoTheFrontroomsPickUpComponent* PickUpComponent);
+
 protected:
 	/** Called for movement input */
 	void Move(const FInputActionValue& Value);
@@ -102,24 +108,60 @@ protected:
 public:
 	// Note Collection System (ONLY NEW ADDITION)
 
-	/** Array of collected notes */
+	/** Collected notes in the order they were collected (the journal), ID and title only */
 	UPROPERTY(BlueprintReadOnly, Category = "Notes")
 	TArray<FCollectedNote> CollectedNotes;
 
-	/** Add a note to the collected notes array */
+	/** Add a note to the collected notes array, the image is streamed in with the rest of the content before OnNoteCollected */
 	UFUNCTION(BlueprintCallable, Category = "Notes")
-	void AddNote(FName NoteID, FText NoteTitle, FText NoteContent, UTexture2D* NoteImage);
+	void AddNote(FName NoteID, FText NoteTitle, FText NoteContent, const TSoftObjectPtr<UTexture2D>& NoteImage);
+
+	/** Get all collected notes (for pause menu), by reference so native callers don't copy */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Notes")
+	const TArray<FCollectedNote>& GetCollectedNotes() const { return CollectedNotes; }
 
-	/** Get all collected notes (for pause menu) */
+	/** Number of collected notes */
 	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Notes")
-	TArray<FCollectedNote> GetCollectedNotes() const { return CollectedNotes; }
+	int32 GetNumCollectedNotes() const { return CollectedNotes.Num(); }
+
+	/** Copy one page of the journal into OutNotes (reuse the array between calls), returns the number of pages */
+	UFUNCTION(BlueprintCallable, Category = "Notes")
+	int32 GetCollectedNotesPage(int32 PageIndex, int32 PageSize, TArray<FCollectedNote>& OutNotes) const;
 
 	/** Check if a specific note has been collected */
 	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Notes")
 	bool HasCollectedNote(FName NoteID) const;
 
-	/** Blueprint event called when a note is collected - Use this in your pause menu to show notification */
+	/** Blueprint event called when a note is collected, once its content has streamed in - Use this in your pause menu to show notification */
 	UFUNCTION(BlueprintImplementableEvent, Category = "Notes")
 	void OnNoteCollected(const FCollectedNote& Note);
+
+	/** Blueprint event called when any health pack (actor or pickup field instance) is collected - Restore HealAmount in your health system */
+	UFUNCTION(BlueprintImplementableEvent, Category = "Health")
+	void OnHealthPackCollected(float HealAmount);
+
+protected:
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	// Collected state, one bit per stable UNoteRegistrySubsystem note index (NoteIDs and the note database)
+	UPROPERTY(ReplicatedUsing = OnRep_CollectedNoteBits)
+	TArray<uint32> CollectedNoteBits;
+
+	UFUNCTION()
+	void OnRep_CollectedNoteBits(const TArray<uint32>& PreviousBits);
+
+	// Collected notes without a stable registry index (not in NoteIDs or the note database), in collection order.
+	// Their indices differ between machines, so they replicate by ID.
+	UPROPERTY(ReplicatedUsing = OnRep_CollectedRuntimeNoteIDs)
+	TArray<FName> CollectedRuntimeNoteIDs;
+
+	UFUNCTION()
+	void OnRep_CollectedRuntimeNoteIDs(const TArray<FName>& PreviousIDs);
+
+	// True if the bit of note index NoteIndex is set
+	bool IsNoteBitSet(int32 NoteIndex) const;
+
+	// Append a registered note to the journal, stream its content in and notify Blueprint
+	void AddToJournal(int32 NoteIndex);
 };
 
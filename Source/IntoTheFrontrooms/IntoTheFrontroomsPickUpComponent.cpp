@@ -1,31 +1,57 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "IntoTheFrontroomsPickUpComponent.h"
+#include "PickupProximitySubsystem.h"
+#include "Engine/World.h"
 
 UIntoTheFrontroomsPickUpComponent::UIntoTheFrontroomsPickUpComponent()
 {
 	// Setup the Sphere Collision
 	SphereRadius = 32.f;
+
+	// Detected by UPickupProximitySubsystem, not by overlaps
+	SetGenerateOverlapEvents(false);
+	SetCollisionProfileName(TEXT("Pickup"));
 }
 
 void UIntoTheFrontroomsPickUpComponent::BeginPlay()
 {
 	Super::BeginPlay();
 
-	// Register our Overlap Event
-	OnComponentBeginOverlap.AddDynamic(this, &UIntoTheFrontroomsPickUpComponent::OnSphereBeginOverlap);
+	// Register with the server-side proximity check
+	if (GetOwner() && GetOwner()->HasAuthority())
+	{
+		if (UPickupProximitySubsystem* Proximity = UWorld::GetSubsystem<UPickupProximitySubsystem>(GetWorld()))
+		{
+			Proximity->RegisterPickup(this);
+		}
+	}
+}
+
+void UIntoTheFrontroomsPickUpComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UPickupProximitySubsystem* Proximity = UWorld::GetSubsystem<UPickupProximitySubsystem>(GetWorld()))
+	{
+		Proximity->UnregisterPickup(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
-void UIntoTheFrontroomsPickUpComponent::OnSphereBeginOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+void UIntoTheFrontroomsPickUpComponent::NotifyPickedUp(AIntoTheFrontroomsCharacter* Character)
 {
-	// Checking if it is a First Person Character overlapping
-	AIntoTheFrontroomsCharacter* Character = Cast<AIntoTheFrontroomsCharacter>(OtherActor);
+	// Checking if it is a First Person Character
 	if(Character != nullptr)
 	{
 		// Notify that the actor is being picked up
+		// The subsystem has already unregistered this pickup so it is no longer triggered
 		OnPickUp.Broadcast(Character);
 
-		// Unregister from the Overlap Event so it is no longer triggered
-		OnComponentBeginOverlap.RemoveAll(this);
+		// Pickup is detected on the server, but attaching a weapon binds input through the local player,
+		// which only exists on the owning client
+		if (!Character->IsLocallyControlled())
+		{
+			Character->ClientNotifyPickedUp(this);
+		}
 	}
 }
@@ -23,12 +23,14 @@ public:
 	FOnPickUp OnPickUp;
 
 	UIntoTheFrontroomsPickUpComponent();
+
+	/** Called by UPickupProximitySubsystem on the server when a character reaches this pickup, OnPickUp then also fires on the owning client */
+	void NotifyPickedUp(AIntoTheFrontroomsCharacter* Character);
 protected:
 
 	/** Called when the game starts */
 	virtual void BeginPlay() override;
 
-	/** Code for when something overlaps this component */
-	UFUNCTION()
-	void OnSphereBeginOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
+	/** Called when the component is removed from play */
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 };
\ No newline at end of file
@@ -0,0 +1,60 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "NoteDatabase.generated.h"
+
+class UTexture2D;
+
+/**
+ * Heavy content of one note (text and image), kept out of the level and loaded on demand
+ */
+UCLASS(BlueprintType)
+class INTOTHEFRONTROOMS_API UNoteContent : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	/** Note text */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Note", meta = (MultiLine = true))
+	FText NoteContent;
+
+	/** Optional image, loaded together with the text */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Note")
+	TObjectPtr<UTexture2D> NoteImage;
+};
+
+/** One note of the database */
+USTRUCT(BlueprintType)
+struct FNoteDefinition
+{
+	GENERATED_BODY()
+
+	/** Unique ID, as set on the note pickups */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Note")
+	FName NoteID;
+
+	/** Title shown in the journal list, always resident */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Note")
+	FText NoteTitle;
+
+	/** Text and image, streamed in when the note is picked up or opened */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Note")
+	TSoftObjectPtr<UNoteContent> Content;
+};
+
+/**
+ * Every story note in one asset. Only IDs and titles are resident, content is soft referenced.
+ * The order is the note index order of replicated journals, so append new notes at the end.
+ */
+UCLASS(BlueprintType)
+class INTOTHEFRONTROOMS_API UNoteDatabase : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Notes")
+	TArray<FNoteDefinition> Notes;
+};
@@ -2,6 +2,8 @@
 
 #include "NotePickup.h"
 #include "IntoTheFrontroomsCharacter.h"
+#include "NoteRegistrySubsystem.h"
+#include "Engine/GameInstance.h"
 
 ANotePickup::ANotePickup()
 {
@@ -9,7 +11,17 @@ ANotePickup::ANotePickup()
 	NoteTitle = FText::FromString("Untitled Note");
 	NoteContent = FText::FromString("Set note content in Blueprint...");
 	NoteID = FName("Note_Default");
-	NoteImage = nullptr;
+}
+
+void ANotePickup::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// Register on every machine so replicated journals can look the note up by index
+	if (UNoteRegistrySubsystem* Registry = GetGameInstance() ? GetGameInstance()->GetSubsystem<UNoteRegistrySubsystem>() : nullptr)
+	{
+		Registry->RegisterNote(NoteID, NoteTitle, NoteContent, NoteImage);
+	}
 }
 
 void ANotePickup::Pickup_Implementation(AIntoTheFrontroomsCharacter* OwningCharacter)
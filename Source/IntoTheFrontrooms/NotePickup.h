@@ -18,6 +18,10 @@ public:
 	ANotePickup();
 
 protected:
+	virtual void BeginPlay() override;
+
+	// Title, content and image are only used for notes missing from the note database
+
 	// Title of the note (displayed in pause menu)
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Note")
 	FText NoteTitle;
@@ -26,9 +30,9 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Note", meta = (MultiLine = true))
 	FText NoteContent;
 
-	// Optional image/texture for the note
+	// Optional image/texture for the note, streamed in when the note is read
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Note")
-	UTexture2D* NoteImage;
+	TSoftObjectPtr<UTexture2D> NoteImage;
 
 	// Unique ID for this note (useful for tracking collected notes)
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Note")
@@ -0,0 +1,238 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "NoteRegistrySubsystem.h"
+#include "NoteDatabase.h"
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
+#include "Engine/Texture2D.h"
+
+void UNoteRegistrySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// Configured notes take the first indices, content arrives when their pickups register
+	for (const FName& NoteID : NoteIDs)
+	{
+		AddOrUpdateNote(NoteID, FText::GetEmpty(), FText::GetEmpty(), nullptr);
+	}
+
+	// The database itself is only IDs, titles and soft references
+	if (const UNoteDatabase* Database = NoteDatabase.LoadSynchronous())
+	{
+		for (const FNoteDefinition& Definition : Database->Notes)
+		{
+			const int32 Index = AddOrUpdateNote(Definition.NoteID, Definition.NoteTitle, FText::GetEmpty(), nullptr);
+			if (Index != INDEX_NONE)
+			{
+				Notes[Index].NoteTitle = Definition.NoteTitle;
+				ContentAssets[Index] = Definition.Content;
+			}
+		}
+	}
+
+	// Everything registered from here on has a machine-local index
+	NumStableNotes = Notes.Num();
+}
+
+void UNoteRegistrySubsystem::Deinitialize()
+{
+	ReleaseAllNoteContent();
+
+	Super::Deinitialize();
+}
+
+int32 UNoteRegistrySubsystem::RegisterNote(FName NoteID, const FText& NoteTitle, const FText& NoteContent, const TSoftObjectPtr<UTexture2D>& NoteImage)
+{
+	if (!NoteID.IsNone() && !IndexByID.Contains(NoteID))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Note '%s' is not in NoteIDs or the note database, it replicates by ID instead of as a journal bit. Add it to the database."), *NoteID.ToString());
+	}
+
+	return AddOrUpdateNote(NoteID, NoteTitle, NoteContent, NoteImage);
+}
+
+int32 UNoteRegistrySubsystem::AddOrUpdateNote(FName NoteID, const FText& NoteTitle, const FText& NoteContent, const TSoftObjectPtr<UTexture2D>& NoteImage)
+{
+	if (NoteID.IsNone())
+		return INDEX_NONE;
+
+	if (const int32* Existing = IndexByID.Find(NoteID))
+	{
+		// Database content wins over whatever a pickup carries
+		FCollectedNote& Note = Notes[*Existing];
+		if (ContentAssets[*Existing].IsNull() && Note.NoteTitle.IsEmpty() && Note.NoteContent.IsEmpty() && Images[*Existing].IsNull())
+		{
+			Note.NoteTitle = NoteTitle;
+			Note.NoteContent = NoteContent;
+			Images[*Existing] = NoteImage;
+		}
+		return *Existing;
+	}
+
+	FCollectedNote& Note = Notes.AddDefaulted_GetRef();
+	Note.NoteID = NoteID;
+	Note.NoteTitle = NoteTitle;
+	Note.NoteContent = NoteContent;
+	ContentAssets.AddDefaulted();
+	Images.Add(NoteImage);
+
+	const int32 Index = Notes.Num() - 1;
+	IndexByID.Add(NoteID, Index);
+	return Index;
+}
+
+int32 UNoteRegistrySubsystem::FindNoteIndex(FName NoteID) const
+{
+	const int32* Index = IndexByID.Find(NoteID);
+	return Index ? *Index : INDEX_NONE;
+}
+
+const FCollectedNote* UNoteRegistrySubsystem::GetNote(int32 Index) const
+{
+	return Notes.IsValidIndex(Index) ? &Notes[Index] : nullptr;
+}
+
+FCollectedNote UNoteRegistrySubsystem::MakeLoadedNote(int32 NoteIndex) const
+{
+	FCollectedNote Note = Notes[NoteIndex];
+	if (const UNoteContent* Content = ContentAssets[NoteIndex].Get())
+	{
+		Note.NoteContent = Content->NoteContent;
+		Note.NoteImage = Content->NoteImage;
+	}
+	else
+	{
+		Note.NoteImage = Images[NoteIndex].Get();
+	}
+	return Note;
+}
+
+void UNoteRegistrySubsystem::LoadNoteContent(FName NoteID, FOnNoteContentLoaded OnLoaded)
+{
+	LoadNoteContentByIndex(FindNoteIndex(NoteID), [OnLoaded](const FCollectedNote& Note)
+	{
+		OnLoaded.ExecuteIfBound(Note);
+	});
+}
+
+void UNoteRegistrySubsystem::LoadNoteContentByIndex(int32 NoteIndex, TFunction<void(const FCollectedNote&)>&& OnLoaded)
+{
+	if (!Notes.IsValidIndex(NoteIndex))
+		return;
+
+	TArray<FSoftObjectPath> Paths;
+	if (!ContentAssets[NoteIndex].IsNull())
+	{
+		Paths.Add(ContentAssets[NoteIndex].ToSoftObjectPath());
+	}
+	else if (!Images[NoteIndex].IsNull())
+	{
+		Paths.Add(Images[NoteIndex].ToSoftObjectPath());
+	}
+
+	// Nothing to stream
+	if (Paths.Num() == 0)
+	{
+		OnLoaded(MakeLoadedNote(NoteIndex));
+		return;
+	}
+
+	// Already streamed, or streaming: share the handle rather than request again
+	if (FNoteContentLoad* Existing = ContentLoads.Find(NoteIndex))
+	{
+		if (Existing->Handle.IsValid() && Existing->Handle->HasLoadCompleted())
+		{
+			OnLoaded(MakeLoadedNote(NoteIndex));
+		}
+		else
+		{
+			Existing->PendingCallbacks.Add(MoveTemp(OnLoaded));
+		}
+		return;
+	}
+
+	// Queue the callback first, content already in memory completes inside RequestAsyncLoad
+	ContentLoads.Add(NoteIndex).PendingCallbacks.Add(MoveTemp(OnLoaded));
+
+	TWeakObjectPtr<UNoteRegistrySubsystem> WeakThis(this);
+	TSharedPtr<FStreamableHandle> Handle = UAssetManager::GetStreamableManager().RequestAsyncLoad(Paths,
+		[WeakThis, NoteIndex]()
+		{
+			if (UNoteRegistrySubsystem* This = WeakThis.Get())
+			{
+				This->OnNoteContentLoaded(NoteIndex);
+			}
+		});
+
+	if (FNoteContentLoad* Load = ContentLoads.Find(NoteIndex))
+	{
+		Load->Handle = Handle;
+		if (!Handle.IsValid())
+		{
+			// Nothing could be requested, complete with what is resident
+			OnNoteContentLoaded(NoteIndex);
+			ContentLoads.Remove(NoteIndex);
+		}
+	}
+}
+
+void UNoteRegistrySubsystem::OnNoteContentLoaded(int32 NoteIndex)
+{
+	FNoteContentLoad* Load = ContentLoads.Find(NoteIndex);
+	if (!Load)
+		return;
+
+	// Callbacks may request more content, don't hold on to the map entry while they run
+	TArray<TFunction<void(const FCollectedNote&)>> Callbacks = MoveTemp(Load->PendingCallbacks);
+	Load->PendingCallbacks.Reset();
+
+	const FCollectedNote Note = MakeLoadedNote(NoteIndex);
+	for (TFunction<void(const FCollectedNote&)>& Callback : Callbacks)
+	{
+		Callback(Note);
+	}
+}
+
+void UNoteRegistrySubsystem::ReleaseLoad(int32 NoteIndex, FNoteContentLoad& Load)
+{
+	if (Load.Handle.IsValid())
+	{
+		// Cancelling never calls the completion callback, answer the waiting requests here
+		if (Load.Handle->HasLoadCompleted())
+		{
+			Load.Handle->ReleaseHandle();
+		}
+		else
+		{
+			Load.Handle->CancelHandle();
+		}
+	}
+
+	for (TFunction<void(const FCollectedNote&)>& Callback : Load.PendingCallbacks)
+	{
+		Callback(Notes[NoteIndex]);
+	}
+}
+
+void UNoteRegistrySubsystem::ReleaseNoteContent(FName NoteID)
+{
+	const int32 NoteIndex = FindNoteIndex(NoteID);
+
+	FNoteContentLoad Load;
+	if (ContentLoads.RemoveAndCopyValue(NoteIndex, Load))
+	{
+		ReleaseLoad(NoteIndex, Load);
+	}
+}
+
+void UNoteRegistrySubsystem::ReleaseAllNoteContent()
+{
+	// Waiting callbacks may request content again, those requests start fresh
+	TMap<int32, FNoteContentLoad> Loads = MoveTemp(ContentLoads);
+	ContentLoads.Reset();
+
+	for (TPair<int32, FNoteContentLoad>& Pair : Loads)
+	{
+		ReleaseLoad(Pair.Key, Pair.Value);
+	}
+}
@@ -0,0 +1,117 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "IntoTheFrontroomsCharacter.h"
+#include "NoteRegistrySubsystem.generated.h"
+
+class UTexture2D;
+class UNoteContent;
+class UNoteDatabase;
+struct FStreamableHandle;
+
+DECLARE_DYNAMIC_DELEGATE_OneParam(FOnNoteContentLoaded, const FCollectedNote&, Note);
+
+// Streaming state of one note's content
+struct FNoteContentLoad
+{
+	// Keeps the content resident once loaded
+	TSharedPtr<FStreamableHandle> Handle;
+
+	// Requests waiting for the load, all completed together
+	TArray<TFunction<void(const FCollectedNote&)>> PendingCallbacks;
+};
+
+/**
+ * Assigns every note an index so collected notes can be kept as a bitset.
+ * NoteIDs, then the notes of NoteDatabase, are the index authority: they get their position as index,
+ * which is the same on every machine, and only they are replicated as bits. Notes first seen at runtime
+ * (registered by pickups in BeginPlay) are appended after them in local registration order, which differs
+ * between machines, so they are replicated by ID instead and a warning asks for them to be added to the database.
+ *
+ * Only IDs and titles stay resident. Note text and images are soft referenced and streamed in by
+ * LoadNoteContent, and stay loaded until released (e.g. when the journal closes).
+ */
+UCLASS(config=Game)
+class INTOTHEFRONTROOMS_API UNoteRegistrySubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// USubsystem interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/** Register a note and its content, returns its index. Content of an already registered note is filled in if it had none. */
+	int32 RegisterNote(FName NoteID, const FText& NoteTitle, const FText& NoteContent, const TSoftObjectPtr<UTexture2D>& NoteImage);
+
+	/** Index of a registered note, INDEX_NONE if unknown */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Notes")
+	int32 FindNoteIndex(FName NoteID) const;
+
+	/** True if the note at Index comes from NoteIDs or NoteDatabase, so its index is the same on every machine */
+	bool HasStableIndex(int32 Index) const { return Index >= 0 && Index < NumStableNotes; }
+
+	/** Resident part of the registered note at Index (ID, title, inline text, no image), null if out of range */
+	const FCollectedNote* GetNote(int32 Index) const;
+
+	/** Number of registered notes */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Notes")
+	int32 GetNumNotes() const { return Notes.Num(); }
+
+	/** Stream in a note's text and image, OnLoaded gets the complete note (right away if already loaded).
+	 *  Requests made while the note is streaming share the load. */
+	UFUNCTION(BlueprintCallable, Category = "Notes")
+	void LoadNoteContent(FName NoteID, FOnNoteContentLoaded OnLoaded);
+
+	/** Native version of LoadNoteContent, by note index */
+	void LoadNoteContentByIndex(int32 NoteIndex, TFunction<void(const FCollectedNote&)>&& OnLoaded);
+
+	/** Let a note's text and image unload. Requests still waiting are cancelled and get the note without content. */
+	UFUNCTION(BlueprintCallable, Category = "Notes")
+	void ReleaseNoteContent(FName NoteID);
+
+	/** Let every loaded note unload, call when the journal closes */
+	UFUNCTION(BlueprintCallable, Category = "Notes")
+	void ReleaseAllNoteContent();
+
+	/** Notes with a fixed index, in index order, before the database notes */
+	UPROPERTY(Config, BlueprintReadOnly, Category = "Notes")
+	TArray<FName> NoteIDs;
+
+	/** Story notes, their order is their index order after NoteIDs */
+	UPROPERTY(Config, BlueprintReadOnly, Category = "Notes")
+	TSoftObjectPtr<UNoteDatabase> NoteDatabase;
+
+protected:
+	// Complete note at NoteIndex, with text and image from whatever is loaded
+	FCollectedNote MakeLoadedNote(int32 NoteIndex) const;
+
+	// Run the callbacks waiting for a note's content
+	void OnNoteContentLoaded(int32 NoteIndex);
+
+	// Cancel or release a load, completing its waiting callbacks with the resident part of the note
+	void ReleaseLoad(int32 NoteIndex, FNoteContentLoad& Load);
+
+	// Register a note, or fill in the content of an already registered one that has none
+	int32 AddOrUpdateNote(FName NoteID, const FText& NoteTitle, const FText& NoteContent, const TSoftObjectPtr<UTexture2D>& NoteImage);
+
+	// Notes from NoteIDs and NoteDatabase, they take the first indices
+	int32 NumStableNotes = 0;
+
+	// Every registered note without its image, indexed by note index
+	UPROPERTY()
+	TArray<FCollectedNote> Notes;
+
+	// Soft content of each note, matching Notes. Database notes use ContentAssets, pickup notes Images.
+	TArray<TSoftObjectPtr<UNoteContent>> ContentAssets;
+	TArray<TSoftObjectPtr<UTexture2D>> Images;
+
+	// Note index by ID
+	TMap<FName, int32> IndexByID;
+
+	// Loading and loaded content, by note index
+	TMap<int32, FNoteContentLoad> ContentLoads;
+};
@@ -0,0 +1,296 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "PickupField.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "IntoTheFrontroomsCharacter.h"
+#include "EffectPoolSubsystem.h"
+#include "NoteRegistrySubsystem.h"
+#include "PickupProximitySubsystem.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
+
+APickupField::APickupField()
+{
+	// Players are matched against the instances by UPickupProximitySubsystem
+	PrimaryActorTick.bCanEverTick = false;
+
+	// Instances are only drawn, collection runs through the proximity subsystem
+	Instances = CreateDefaultSubobject<UHierarchicalInstancedStaticMeshComponent>(TEXT("Instances"));
+	RootComponent = Instances;
+	Instances->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	Instances->SetCanEverAffectNavigation(false);
+
+	PickupRadius = 100.0f; // Same as the APickupParent sphere
+	PickupSound = nullptr;
+	PickupEffect = nullptr;
+	JoinSnapshotWindow = 2.0f;
+
+	// Only the collected bits replicate, the field stays dormant until one changes
+	bReplicates = true;
+	SetReplicatingMovement(false);
+	NetDormancy = DORM_Initial;
+}
+
+void APickupField::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+	DOREPLIFETIME_WITH_PARAMS_FAST(APickupField, CollectedBits, Params);
+}
+
+void APickupField::OnConstruction(const FTransform& Transform)
+{
+	Super::OnConstruction(Transform);
+
+	// The construction script adds its scatter again after this
+	ScatteredEntries.Reset();
+	RebuildInstances(true);
+}
+
+const FPickupFieldEntry& APickupField::GetEntry(int32 InstanceIndex) const
+{
+	return InstanceIndex < Entries.Num() ? Entries[InstanceIndex] : ScatteredEntries[InstanceIndex - Entries.Num()];
+}
+
+int32 APickupField::AddPickup(const FPickupFieldEntry& Entry)
+{
+	ScatteredEntries.Add(Entry);
+	AddInstanceData(Entry, true);
+
+	const int32 InstanceIndex = Types.Num() - 1;
+	if (HasActorBegunPlay())
+	{
+		RegisterInstance(InstanceIndex);
+	}
+	return InstanceIndex;
+}
+
+void APickupField::AddInstanceData(const FPickupFieldEntry& Entry, bool bAddMeshInstance)
+{
+	if (bAddMeshInstance)
+	{
+		Instances->AddInstance(Entry.Transform);
+	}
+
+	Types.Add(Entry.Type);
+	NoteIDs.Add(Entry.NoteID);
+	HealAmounts.Add(Entry.HealAmount);
+	Locations.Add(GetActorTransform().TransformPosition(Entry.Transform.GetLocation()));
+	AppliedCollected.Add(false);
+}
+
+void APickupField::RebuildInstances(bool bRebuildMeshInstances)
+{
+	if (bRebuildMeshInstances)
+	{
+		Instances->ClearInstances();
+	}
+
+	const int32 NumEntries = Entries.Num() + ScatteredEntries.Num();
+	Types.Reset(NumEntries);
+	NoteIDs.Reset(NumEntries);
+	HealAmounts.Reset(NumEntries);
+	Locations.Reset(NumEntries);
+	AppliedCollected.Reset();
+
+	for (const FPickupFieldEntry& Entry : Entries)
+	{
+		AddInstanceData(Entry, bRebuildMeshInstances);
+	}
+	for (const FPickupFieldEntry& Entry : ScatteredEntries)
+	{
+		AddInstanceData(Entry, bRebuildMeshInstances);
+	}
+}
+
+void APickupField::RegisterInstance(int32 InstanceIndex)
+{
+	// Collection is detected on the server only, clients follow the collected bits
+	if (!HasAuthority() || IsInstanceCollected(InstanceIndex))
+		return;
+
+	if (UPickupProximitySubsystem* Proximity = UWorld::GetSubsystem<UPickupProximitySubsystem>(GetWorld()))
+	{
+		Proximity->RegisterFieldInstance(this, InstanceIndex, Locations[InstanceIndex], PickupRadius);
+	}
+}
+
+void APickupField::BeginPlay()
+{
+	Super::BeginPlay();
+
+	BeginPlayTime = GetWorld()->GetTimeSeconds();
+
+	// Mesh instances are saved with the level, only rebuild them if they went out of sync
+	const int32 NumEntries = Entries.Num() + ScatteredEntries.Num();
+	RebuildInstances(Instances->GetInstanceCount() != NumEntries);
+
+	// Initial dormancy only applies to actors placed in the level
+	if (HasAuthority() && !IsNetStartupActor())
+	{
+		SetNetDormancy(DORM_DormantAll);
+	}
+
+	// Register notes on every machine so replicated journals can look them up by index
+	if (UNoteRegistrySubsystem* Registry = GetGameInstance() ? GetGameInstance()->GetSubsystem<UNoteRegistrySubsystem>() : nullptr)
+	{
+		for (int32 InstanceIndex = 0; InstanceIndex < Types.Num(); ++InstanceIndex)
+		{
+			if (Types[InstanceIndex] == EPickupFieldType::Note)
+			{
+				const FPickupFieldEntry& Entry = GetEntry(InstanceIndex);
+				Registry->RegisterNote(NoteIDs[InstanceIndex], Entry.NoteTitle, Entry.NoteContent, Entry.NoteImage);
+			}
+		}
+	}
+
+	if (UEffectPoolSubsystem* Effects = UWorld::GetSubsystem<UEffectPoolSubsystem>(GetWorld()))
+	{
+		Effects->Prewarm(PickupEffect);
+	}
+
+	// Collected bits may have arrived before the instances were set up, hide them without effects
+	ApplyCollectedBits(nullptr);
+
+	for (int32 InstanceIndex = 0; InstanceIndex < Types.Num(); ++InstanceIndex)
+	{
+		RegisterInstance(InstanceIndex);
+	}
+}
+
+void APickupField::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UPickupProximitySubsystem* Proximity = UWorld::GetSubsystem<UPickupProximitySubsystem>(GetWorld()))
+	{
+		Proximity->UnregisterField(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+bool APickupField::IsInstanceCollected(int32 InstanceIndex) const
+{
+	const int32 Word = InstanceIndex / 32;
+	return InstanceIndex >= 0 && CollectedBits.IsValidIndex(Word) && (CollectedBits[Word] & (1u << (InstanceIndex % 32))) != 0;
+}
+
+void APickupField::PickupInstance_Implementation(AIntoTheFrontroomsCharacter* OwningCharacter, int32 InstanceIndex)
+{
+	if (!OwningCharacter || !Types.IsValidIndex(InstanceIndex) || IsInstanceCollected(InstanceIndex))
+		return;
+
+	switch (Types[InstanceIndex])
+	{
+		case EPickupFieldType::Note:
+		{
+			// Title and content are cold data, read from the entry only on collection
+			const FPickupFieldEntry& Entry = GetEntry(InstanceIndex);
+			OwningCharacter->AddNote(NoteIDs[InstanceIndex], Entry.NoteTitle, Entry.NoteContent, Entry.NoteImage);
+
+			UE_LOG(LogTemp, Log, TEXT("Pickup Field: note '%s' collected by %s"), *Entry.NoteTitle.ToString(), *OwningCharacter->GetName());
+			break;
+		}
+
+		case EPickupFieldType::HealthPack:
+			// Health itself is handled in the Character Blueprint, as with AHealthPackPickup
+			UE_LOG(LogTemp, Log, TEXT("Pickup Field: Player collected health pack (+%.0f HP)"), HealAmounts[InstanceIndex]);
+			OwningCharacter->OnHealthPackCollected(HealAmounts[InstanceIndex]);
+			break;
+	}
+
+	MarkInstanceCollected(InstanceIndex);
+}
+
+void APickupField::MarkInstanceCollected(int32 InstanceIndex)
+{
+	// Wake the field before the change so the collected bits go out
+	if (HasAuthority())
+	{
+		FlushNetDormancy();
+
+		if (UPickupProximitySubsystem* Proximity = UWorld::GetSubsystem<UPickupProximitySubsystem>(GetWorld()))
+		{
+			Proximity->UnregisterFieldInstance(this, InstanceIndex);
+		}
+	}
+
+	const int32 Word = InstanceIndex / 32;
+	if (CollectedBits.Num() <= Word)
+	{
+		CollectedBits.SetNumZeroed(Word + 1);
+	}
+	CollectedBits[Word] |= 1u << (InstanceIndex % 32);
+	MARK_PROPERTY_DIRTY_FROM_NAME(APickupField, CollectedBits, this);
+
+	if (ApplyCollectedInstance(InstanceIndex, true))
+	{
+		Instances->MarkRenderStateDirty();
+	}
+}
+
+bool APickupField::ApplyCollectedInstance(int32 InstanceIndex, bool bPlayEffects)
+{
+	if (!AppliedCollected.IsValidIndex(InstanceIndex) || AppliedCollected[InstanceIndex])
+		return false;
+
+	AppliedCollected[InstanceIndex] = true;
+
+	// Scale to zero rather than remove, removing would reorder instance indices
+	FTransform InstanceTransform;
+	Instances->GetInstanceTransform(InstanceIndex, InstanceTransform);
+	InstanceTransform.SetScale3D(FVector::ZeroVector);
+	Instances->UpdateInstanceTransform(InstanceIndex, InstanceTransform, false, false, true);
+
+	if (!bPlayEffects)
+		return true;
+
+	if (UEffectPoolSubsystem* Effects = UWorld::GetSubsystem<UEffectPoolSubsystem>(GetWorld()))
+	{
+		Effects->PlaySoundAtLocation(PickupSound, Locations[InstanceIndex]);
+		Effects->SpawnEffectAtLocation(PickupEffect, Locations[InstanceIndex], GetActorRotation());
+	}
+	return true;
+}
+
+void APickupField::OnRep_CollectedBits(const TArray<uint32>& PreviousBits)
+{
+	// The first bits a late joiner or a spawned field receives are everything collected before,
+	// playing their effects would fire every earlier pickup at once. A field loaded with the level
+	// starts with nothing collected on every machine, so a client that has had it for a while
+	// compares its first bits against that and plays the collection it just watched.
+	const bool bStartupBaseline = IsNetStartupActor() && HasActorBegunPlay() &&
+		GetWorld()->GetTimeSeconds() - BeginPlayTime > JoinSnapshotWindow;
+	const bool bSeenChanging = bReceivedCollectedBits || bStartupBaseline;
+	bReceivedCollectedBits = true;
+
+	ApplyCollectedBits(bSeenChanging ? &PreviousBits : nullptr);
+}
+
+void APickupField::ApplyCollectedBits(const TArray<uint32>* PreviousBits)
+{
+	// One render state update for everything that changed
+	bool bChanged = false;
+	for (int32 Word = 0; Word < CollectedBits.Num(); ++Word)
+	{
+		if (CollectedBits[Word] == 0)
+			continue;
+
+		const uint32 NewBits = PreviousBits ? CollectedBits[Word] & ~(PreviousBits->IsValidIndex(Word) ? (*PreviousBits)[Word] : 0u) : 0u;
+		for (int32 Bit = 0; Bit < 32; ++Bit)
+		{
+			if (CollectedBits[Word] & (1u << Bit))
+			{
+				bChanged |= ApplyCollectedInstance(Word * 32 + Bit, (NewBits & (1u << Bit)) != 0);
+			}
+		}
+	}
+
+	if (bChanged)
+	{
+		Instances->MarkRenderStateDirty();
+	}
+}
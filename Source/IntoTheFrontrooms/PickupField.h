@@ -0,0 +1,170 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "PickupField.generated.h"
+
+class UHierarchicalInstancedStaticMeshComponent;
+class AIntoTheFrontroomsCharacter;
+class USoundBase;
+class UFXSystemAsset;
+class UTexture2D;
+
+// What an instance in a pickup field gives when collected
+UENUM(BlueprintType)
+enum class EPickupFieldType : uint8
+{
+	Note		UMETA(DisplayName = "Note"),
+	HealthPack	UMETA(DisplayName = "Health Pack")
+};
+
+/** One pickup in a field, as authored in the editor or added at runtime */
+USTRUCT(BlueprintType)
+struct FPickupFieldEntry
+{
+	GENERATED_BODY()
+
+	/** Transform relative to the field */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pickup")
+	FTransform Transform;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pickup")
+	EPickupFieldType Type = EPickupFieldType::Note;
+
+	/** Unique ID of the note (Note only) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pickup", meta = (EditCondition = "Type == EPickupFieldType::Note"))
+	FName NoteID;
+
+	/** Title shown in the pause menu (Note only) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pickup", meta = (EditCondition = "Type == EPickupFieldType::Note"))
+	FText NoteTitle;
+
+	/** Note text (Note only) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pickup", meta = (MultiLine = true, EditCondition = "Type == EPickupFieldType::Note"))
+	FText NoteContent;
+
+	/** Optional image, streamed in when the note is read (Note only) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pickup", meta = (EditCondition = "Type == EPickupFieldType::Note"))
+	TSoftObjectPtr<UTexture2D> NoteImage;
+
+	/** Health restored (Health Pack only) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pickup", meta = (EditCondition = "Type == EPickupFieldType::HealthPack"))
+	float HealAmount = 25.0f;
+};
+
+/**
+ * Many same-mesh pickups rendered as instances of one hierarchical instanced static mesh.
+ * Hot per-instance data (type, payload, location, collected state) lives in flat arrays and each
+ * uncollected instance is registered with UPickupProximitySubsystem like any other pickup,
+ * so thousands of collectibles need no per-pickup actors, collision components or scene proxies.
+ * Collection goes through PickupInstance, the field counterpart of APickupParent::Pickup.
+ * The collected bits are the only replicated state and the field stays net dormant otherwise.
+ */
+UCLASS()
+class INTOTHEFRONTROOMS_API APickupField : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	APickupField();
+
+	virtual void OnConstruction(const FTransform& Transform) override;
+
+	/** Add a pickup from a scatter construction script, returns its instance index.
+	 *  Pickups added at runtime are not replicated, add them identically on every machine. */
+	UFUNCTION(BlueprintCallable, Category = "Pickup")
+	int32 AddPickup(const FPickupFieldEntry& Entry);
+
+	/** Number of pickups in the field */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Pickup")
+	int32 GetNumPickups() const { return Types.Num(); }
+
+	/** True once the instance has been collected */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Pickup")
+	bool IsInstanceCollected(int32 InstanceIndex) const;
+
+	// Pickup logic for one instance, can be overridden in BP like APickupParent::Pickup
+	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "Pickup")
+	void PickupInstance(AIntoTheFrontroomsCharacter* OwningCharacter, int32 InstanceIndex);
+	virtual void PickupInstance_Implementation(AIntoTheFrontroomsCharacter* OwningCharacter, int32 InstanceIndex);
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	// Instances of the shared pickup mesh (set the mesh in Blueprint)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Pickup")
+	TObjectPtr<UHierarchicalInstancedStaticMeshComponent> Instances;
+
+	// Pickups placed by hand, their indices come first
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Pickup")
+	TArray<FPickupFieldEntry> Entries;
+
+	// Pickups added through AddPickup, cleared whenever the construction script reruns
+	UPROPERTY()
+	TArray<FPickupFieldEntry> ScatteredEntries;
+
+	// Pickup sphere radius of each instance, tested against the player capsule like the APickupParent sphere
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pickup")
+	float PickupRadius;
+
+	// Optional sound to play when an instance is picked up
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pickup|Effects")
+	TObjectPtr<USoundBase> PickupSound;
+
+	// Optional effect (Niagara or Cascade) to spawn when an instance is picked up
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pickup|Effects")
+	TObjectPtr<UFXSystemAsset> PickupEffect;
+
+	// Collected bits arriving this long after the field began play on a client that loaded it with the level
+	// are a collection seen happening, earlier ones are the snapshot sent to a late joiner
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pickup|Effects")
+	float JoinSnapshotWindow;
+
+	// Authored or scattered entry of an instance
+	const FPickupFieldEntry& GetEntry(int32 InstanceIndex) const;
+
+	// Append one entry's flat data, and its mesh instance if bAddMeshInstance
+	void AddInstanceData(const FPickupFieldEntry& Entry, bool bAddMeshInstance);
+
+	// Rebuild the flat arrays from every entry, and the mesh instances if bRebuildMeshInstances
+	void RebuildInstances(bool bRebuildMeshInstances);
+
+	// Register an uncollected instance for server-side proximity detection
+	void RegisterInstance(int32 InstanceIndex);
+
+	// Set the collected bit, hide the instance and play effects
+	void MarkInstanceCollected(int32 InstanceIndex);
+
+	// Hide every collected instance not hidden here yet. Effects only play for bits missing from
+	// PreviousBits, pass null for state that was not seen changing (BeginPlay, joining mid-game).
+	void ApplyCollectedBits(const TArray<uint32>* PreviousBits);
+
+	// Hide a collected instance, and play its effects if bPlayEffects. False if it was already hidden here.
+	bool ApplyCollectedInstance(int32 InstanceIndex, bool bPlayEffects);
+
+	UFUNCTION()
+	void OnRep_CollectedBits(const TArray<uint32>& PreviousBits);
+
+	// Collected state, one bit per instance. The only replicated field state.
+	UPROPERTY(ReplicatedUsing = OnRep_CollectedBits)
+	TArray<uint32> CollectedBits;
+
+	// Flat per-instance data, built from Entries and ScatteredEntries
+	TArray<EPickupFieldType> Types;
+	TArray<FName> NoteIDs;
+	TArray<float> HealAmounts;
+	TArray<FVector> Locations;
+
+	// Instances already hidden on this machine, lags CollectedBits until applied
+	TBitArray<> AppliedCollected;
+
+	// Set by the first replicated collected bits
+	bool bReceivedCollectedBits = false;
+
+	// World time this field began play on this machine
+	double BeginPlayTime = 0.0;
+};
@@ -4,22 +4,26 @@
 #include "Components/SphereComponent.h"
 #include "Components/StaticMeshComponent.h"
 #include "IntoTheFrontroomsCharacter.h"
-#include "Kismet/GameplayStatics.h"
+#include "EffectPoolSubsystem.h"
+#include "PickupSpinSubsystem.h"
+#include "PickupProximitySubsystem.h"
+#include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
 #include "Sound/SoundBase.h"
 #include "Particles/ParticleSystem.h"
 
 // Sets default values
 APickupParent::APickupParent()
 {
-	// Set this actor to call Tick() every frame
-	PrimaryActorTick.bCanEverTick = true;
+	// No tick, the cosmetic spin is driven by UPickupSpinSubsystem
+	PrimaryActorTick.bCanEverTick = false;
 
 	// Create sphere collision component
 	SphereCollision = CreateDefaultSubobject<USphereComponent>(TEXT("SphereCollision"));
 	RootComponent = SphereCollision;
-	SphereCollision->SetGenerateOverlapEvents(true);
+	SphereCollision->SetGenerateOverlapEvents(false);
 	SphereCollision->SetSphereRadius(100.f);
-	SphereCollision->SetCollisionProfileName(TEXT("OverlapAllDynamic"));
+	SphereCollision->SetCollisionProfileName(TEXT("Pickup")); // Own object channel, ignores everything else
 
 	// Create mesh component
 	Mesh = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("Mesh"));
@@ -27,20 +31,57 @@ APickupParent::APickupParent()
 	Mesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
 	Mesh->SetRelativeScale3D(FVector(0.5f)); // Default scale
 
-	// Enable replication for multiplayer
+	// Replicate only the collected flag. Pickups don't move and stay dormant until collected,
+	// so the net driver skips them entirely.
 	bReplicates = true;
-	SetReplicateMovement(true);
+	SetReplicatingMovement(false);
+	NetDormancy = DORM_Initial;
+
+	bCollected = false;
+}
+
+void APickupParent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+	DOREPLIFETIME_WITH_PARAMS_FAST(APickupParent, bCollected, Params);
 }
 
 // Called when the game starts or when spawned
 void APickupParent::BeginPlay()
 {
 	Super::BeginPlay();
-	
-	// Bind overlap event
-	if (SphereCollision)
+
+	// Initial dormancy only applies to actors placed in the level
+	if (HasAuthority() && !IsNetStartupActor())
+	{
+		SetNetDormancy(DORM_DormantAll);
+	}
+
+	// The spin is purely cosmetic and never replicated
+	if (!IsNetMode(NM_DedicatedServer))
 	{
-		SphereCollision->OnComponentBeginOverlap.AddDynamic(this, &APickupParent::OnBeginOverlap);
+		if (UPickupSpinSubsystem* Spin = UWorld::GetSubsystem<UPickupSpinSubsystem>(GetWorld()))
+		{
+			Spin->RegisterMesh(Mesh);
+		}
+	}
+
+	// Players are detected by the server-side proximity check
+	if (HasAuthority() && !bCollected)
+	{
+		if (UPickupProximitySubsystem* Proximity = UWorld::GetSubsystem<UPickupProximitySubsystem>(GetWorld()))
+		{
+			Proximity->RegisterPickup(SphereCollision);
+		}
+	}
+
+	// Every pickup of a kind shares the same pooled effect
+	if (UEffectPoolSubsystem* Effects = UWorld::GetSubsystem<UEffectPoolSubsystem>(GetWorld()))
+	{
+		Effects->Prewarm(PickupEffect);
 	}
 
 	// Warn if mesh is not set
@@ -50,29 +91,18 @@ void APickupParent::BeginPlay()
 	}
 }
 
-// Called every frame
-void APickupParent::Tick(float DeltaTime)
+void APickupParent::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-	Super::Tick(DeltaTime);
-
-	// Rotate the pickup for visual appeal
-	if (Mesh)
+	if (UPickupSpinSubsystem* Spin = UWorld::GetSubsystem<UPickupSpinSubsystem>(GetWorld()))
 	{
-		FRotator NewRotation = Mesh->GetRelativeRotation();
-		NewRotation.Yaw += DeltaTime * 90.0f; // Rotate 90 degrees per second
-		Mesh->SetRelativeRotation(NewRotation);
+		Spin->UnregisterMesh(Mesh);
 	}
-}
-
-void APickupParent::OnBeginOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor,
-	UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
-{
-	// Check if the overlapping actor is a player character
-	AIntoTheFrontroomsCharacter* Character = Cast<AIntoTheFrontroomsCharacter>(OtherActor);
-	if (Character)
+	if (UPickupProximitySubsystem* Proximity = UWorld::GetSubsystem<UPickupProximitySubsystem>(GetWorld()))
 	{
-		Pickup(Character);
+		Proximity->UnregisterPickup(SphereCollision);
 	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void APickupParent::Pickup_Implementation(AIntoTheFrontroomsCharacter* OwningCharacter)
@@ -88,32 +118,60 @@ void APickupParent::Pickup_Implementation(AIntoTheFrontroomsCharacter* OwningCha
 	// Set the owner
 	SetOwner(OwningCharacter);
 
-	// Disable collision to prevent multiple pickups
+	// Wake the pickup before the change so the collected flag goes out
+	if (HasAuthority())
+	{
+		FlushNetDormancy();
+	}
+
+	bCollected = true;
+	MARK_PROPERTY_DIRTY_FROM_NAME(APickupParent, bCollected, this);
+	ApplyCollectedState();
+
+	if (HasAuthority())
+	{
+		// Destroy the actor after a short delay (allows sound/effects to play)
+		SetLifeSpan(0.5f);
+	}
+}
+
+void APickupParent::OnRep_Collected()
+{
+	// Only called when this client didn't already collect it locally
+	if (bCollected)
+	{
+		ApplyCollectedState();
+	}
+}
+
+void APickupParent::ApplyCollectedState()
+{
+	// Disable collision and detection to prevent multiple pickups
 	if (SphereCollision)
 	{
 		SphereCollision->SetCollisionEnabled(ECollisionEnabled::NoCollision);
 	}
+	if (UPickupProximitySubsystem* Proximity = UWorld::GetSubsystem<UPickupProximitySubsystem>(GetWorld()))
+	{
+		Proximity->UnregisterPickup(SphereCollision);
+	}
 
-	// Hide the mesh
+	// Hide the mesh and stop spinning
 	if (Mesh)
 	{
 		Mesh->SetVisibility(false);
 	}
-
-	// Play pickup sound if set
-	if (PickupSound)
+	if (UPickupSpinSubsystem* Spin = UWorld::GetSubsystem<UPickupSpinSubsystem>(GetWorld()))
 	{
-		UGameplayStatics::PlaySoundAtLocation(this, PickupSound, GetActorLocation());
+		Spin->UnregisterMesh(Mesh);
 	}
 
-	// Spawn pickup particle effect if set
-	if (PickupEffect)
+	// Play pickup sound and particle effect from the effect pools
+	if (UEffectPoolSubsystem* Effects = UWorld::GetSubsystem<UEffectPoolSubsystem>(GetWorld()))
 	{
-		UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), PickupEffect, GetActorTransform());
+		Effects->PlaySoundAtLocation(PickupSound, GetActorLocation());
+		Effects->SpawnEffectAtLocation(PickupEffect, GetActorLocation(), GetActorRotation(), GetActorScale3D());
 	}
-
-	// Destroy the actor after a short delay (allows sound/effects to play)
-	SetLifeSpan(0.5f);
 }
 
 
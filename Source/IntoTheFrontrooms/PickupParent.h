@@ -22,12 +22,16 @@ public:
 
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
 public:
-	virtual void Tick(float DeltaTime) override;
+	/** True once the pickup has been collected */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Pickup")
+	bool IsCollected() const { return bCollected; }
 
 protected:
-	// Sphere collision for pickup detection
+	// Pickup radius, detected by UPickupProximitySubsystem on the server rather than by overlaps
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Pickup")
 	USphereComponent* SphereCollision;
 
@@ -43,10 +47,15 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pickup|Effects")
 	UParticleSystem* PickupEffect;
 
-	// Called when overlap begins
+	// Set once collected, the only replicated pickup state. Pickups stay net dormant until this changes.
+	UPROPERTY(ReplicatedUsing = OnRep_Collected)
+	bool bCollected;
+
 	UFUNCTION()
-	void OnBeginOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor,
-		UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
+	void OnRep_Collected();
+
+	// Hide, stop colliding and play the pickup sound and effect
+	void ApplyCollectedState();
 
 public:
 	// BlueprintNativeEvent for pickup logic, can be overridden in BP
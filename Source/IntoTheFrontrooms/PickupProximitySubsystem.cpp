@@ -0,0 +1,205 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "PickupProximitySubsystem.h"
+#include "PickupParent.h"
+#include "PickupField.h"
+#include "IntoTheFrontroomsPickUpComponent.h"
+#include "IntoTheFrontroomsCharacter.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/SphereComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/World.h"
+
+UPickupProximitySubsystem::UPickupProximitySubsystem()
+{
+	CellSize = 1000.0f;
+}
+
+bool UPickupProximitySubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UPickupProximitySubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UPickupProximitySubsystem, STATGROUP_Tickables);
+}
+
+void UPickupProximitySubsystem::RegisterPickup(USphereComponent* Sphere)
+{
+	if (Sphere)
+	{
+		AddEntry(Sphere, INDEX_NONE, Sphere->GetComponentLocation(), Sphere->GetScaledSphereRadius());
+	}
+}
+
+void UPickupProximitySubsystem::UnregisterPickup(USphereComponent* Sphere)
+{
+	const int32 Index = FindEntry(Sphere, INDEX_NONE);
+	if (Index != INDEX_NONE)
+	{
+		RemoveEntry(Index);
+	}
+}
+
+void UPickupProximitySubsystem::RegisterFieldInstance(APickupField* Field, int32 InstanceIndex, const FVector& Location, float Radius)
+{
+	if (Field && InstanceIndex != INDEX_NONE)
+	{
+		AddEntry(Field, InstanceIndex, Location, Radius);
+	}
+}
+
+void UPickupProximitySubsystem::UnregisterFieldInstance(APickupField* Field, int32 InstanceIndex)
+{
+	const int32 Index = FindEntry(Field, InstanceIndex);
+	if (Index != INDEX_NONE)
+	{
+		RemoveEntry(Index);
+	}
+}
+
+void UPickupProximitySubsystem::UnregisterField(APickupField* Field)
+{
+	for (int32 Index = Owners.Num() - 1; Index >= 0; --Index)
+	{
+		if (Keys[Index].Key == Field)
+		{
+			RemoveEntry(Index);
+		}
+	}
+}
+
+void UPickupProximitySubsystem::AddEntry(UObject* Owner, int32 InstanceIndex, const FVector& Location, float Radius)
+{
+	const FPickupProximityKey Key(Owner, InstanceIndex);
+	if (IndexByKey.Contains(Key))
+		return;
+
+	IndexByKey.Add(Key, Owners.Num());
+	Owners.Add(Owner);
+	Keys.Add(Key);
+	Locations.Add(Location);
+	Radii.Add(Radius);
+	MaxRadius = FMath::Max(MaxRadius, Radius);
+	bGridDirty = true;
+}
+
+int32 UPickupProximitySubsystem::FindEntry(const UObject* Owner, int32 InstanceIndex) const
+{
+	const int32* Index = IndexByKey.Find(FPickupProximityKey(Owner, InstanceIndex));
+	return Index ? *Index : INDEX_NONE;
+}
+
+void UPickupProximitySubsystem::RemoveEntry(int32 Index)
+{
+	IndexByKey.Remove(Keys[Index]);
+
+	Owners.RemoveAtSwap(Index);
+	Keys.RemoveAtSwap(Index);
+	Locations.RemoveAtSwap(Index);
+	Radii.RemoveAtSwap(Index);
+	bGridDirty = true;
+
+	// The last pickup moved into the freed slot
+	if (Owners.IsValidIndex(Index))
+	{
+		IndexByKey[Keys[Index]] = Index;
+	}
+}
+
+void UPickupProximitySubsystem::Tick(float DeltaTime)
+{
+	// Clients learn about collected pickups through replication
+	UWorld* World = GetWorld();
+	if (Owners.Num() == 0 || World->GetNetMode() == NM_Client)
+		return;
+
+	// Pickups don't move, the grid only changes when pickups come and go
+	if (bGridDirty)
+	{
+		Grid.SetCellSize(CellSize);
+		Grid.Reset();
+		for (int32 Index = 0; Index < Locations.Num(); ++Index)
+		{
+			Grid.Add(Index, Locations[Index]);
+		}
+		Grid.Build();
+		bGridDirty = false;
+	}
+
+	Hits.Reset();
+	CurrentHits.Reset();
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+	{
+		APlayerController* PC = It->Get();
+		AIntoTheFrontroomsCharacter* Character = PC ? Cast<AIntoTheFrontroomsCharacter>(PC->GetPawn()) : nullptr;
+		if (!Character)
+			continue;
+
+		// Same test as a sphere overlapping the upright capsule
+		const UCapsuleComponent* Capsule = Character->GetCapsuleComponent();
+		const FVector Center = Capsule->GetComponentLocation();
+		const float CapsuleRadius = Capsule->GetScaledCapsuleRadius();
+		const float SegmentHalfHeight = Capsule->GetScaledCapsuleHalfHeight_WithoutHemisphere();
+
+		QueryScratch.Reset();
+		Grid.QueryRadius(Center, MaxRadius + CapsuleRadius + SegmentHalfHeight, QueryScratch);
+		for (int32 Index : QueryScratch)
+		{
+			const FVector& Location = Locations[Index];
+			const FVector Closest(Center.X, Center.Y, FMath::Clamp(Location.Z, Center.Z - SegmentHalfHeight, Center.Z + SegmentHalfHeight));
+			if (FVector::DistSquared(Closest, Location) > FMath::Square(Radii[Index] + CapsuleRadius))
+				continue;
+
+			const TPair<FPickupProximityKey, const AIntoTheFrontroomsCharacter*> Key(Keys[Index], Character);
+			CurrentHits.Add(Key);
+			if (!PreviousHits.Contains(Key))
+			{
+				Hits.Emplace(Keys[Index], Character);
+			}
+		}
+	}
+
+	Swap(PreviousHits, CurrentHits);
+
+	for (const TPair<FPickupProximityKey, AIntoTheFrontroomsCharacter*>& Hit : Hits)
+	{
+		DispatchPickup(Hit.Key, Hit.Value);
+	}
+}
+
+void UPickupProximitySubsystem::DispatchPickup(const FPickupProximityKey& Key, AIntoTheFrontroomsCharacter* Character)
+{
+	// An earlier hit this frame may have collected it already
+	const int32 Index = FindEntry(Key.Key, Key.Value);
+	if (Index == INDEX_NONE || !IsValid(Owners[Index]))
+		return;
+
+	UObject* Owner = Owners[Index];
+	if (APickupField* Field = Cast<APickupField>(Owner))
+	{
+		// Collecting unregisters the instance, an override that refuses leaves it for the next entry
+		if (!Field->IsInstanceCollected(Key.Value))
+		{
+			Field->PickupInstance(Character, Key.Value);
+		}
+	}
+	else if (UIntoTheFrontroomsPickUpComponent* PickUpComponent = Cast<UIntoTheFrontroomsPickUpComponent>(Owner))
+	{
+		UnregisterPickup(PickUpComponent);
+		PickUpComponent->NotifyPickedUp(Character);
+	}
+	else if (APickupParent* Pickup = Cast<APickupParent>(CastChecked<USphereComponent>(Owner)->GetOwner()))
+	{
+		// Collecting unregisters the pickup, an override that refuses leaves it for the next entry
+		if (!Pickup->IsCollected())
+		{
+			Pickup->Pickup(Character);
+		}
+	}
+	else
+	{
+		RemoveEntry(Index);
+	}
+}
@@ -0,0 +1,100 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SpatialHashGrid.h"
+#include "PickupProximitySubsystem.generated.h"
+
+class USphereComponent;
+class APickupField;
+class AIntoTheFrontroomsCharacter;
+
+// Identity of a registered pickup: a sphere component with INDEX_NONE, or a pickup field and instance index
+typedef TPair<const UObject*, int32> FPickupProximityKey;
+
+/**
+ * Server-side pickup detection. Every uncollected pickup sphere and pickup field instance is registered
+ * here and each frame every player's capsule is matched against a spatial hash grid of pickup locations,
+ * so pickups need no overlap events and no broadphase pairs with other moving bodies.
+ * Pickup spheres use the Pickup object channel (ECC_Pickup), which ignores every other
+ * channel, for anything that still queries them. Pickups are expected not to move.
+ */
+UCLASS(config=Game)
+class INTOTHEFRONTROOMS_API UPickupProximitySubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UPickupProximitySubsystem();
+
+	// FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/** Start detecting players inside a pickup sphere (an APickupParent root or a UIntoTheFrontroomsPickUpComponent) */
+	void RegisterPickup(USphereComponent* Sphere);
+
+	/** Stop detecting a pickup, e.g. once it has been collected */
+	void UnregisterPickup(USphereComponent* Sphere);
+
+	/** Start detecting players inside a sphere of Radius around one instance of a pickup field */
+	void RegisterFieldInstance(APickupField* Field, int32 InstanceIndex, const FVector& Location, float Radius);
+
+	/** Stop detecting one pickup field instance, e.g. once it has been collected */
+	void UnregisterFieldInstance(APickupField* Field, int32 InstanceIndex);
+
+	/** Stop detecting every instance of a pickup field */
+	void UnregisterField(APickupField* Field);
+
+	/** Grid cell size, a few times the largest pickup radius */
+	UPROPERTY(Config, BlueprintReadOnly, Category = "Pickup")
+	float CellSize;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	// Add a pickup unless already registered
+	void AddEntry(UObject* Owner, int32 InstanceIndex, const FVector& Location, float Radius);
+
+	// Index of a registered pickup, INDEX_NONE if unknown
+	int32 FindEntry(const UObject* Owner, int32 InstanceIndex) const;
+
+	void RemoveEntry(int32 Index);
+
+	// Collect the pickup behind Key for Character
+	void DispatchPickup(const FPickupProximityKey& Key, AIntoTheFrontroomsCharacter* Character);
+
+	// Sphere component or pickup field of each registered pickup
+	UPROPERTY()
+	TArray<TObjectPtr<UObject>> Owners;
+
+	// Identity of each pickup, matching Owners. Kept raw so it still matches once an owner is gone.
+	TArray<FPickupProximityKey> Keys;
+
+	// World location and scaled radius of each pickup, matching Owners
+	TArray<FVector> Locations;
+	TArray<float> Radii;
+
+	// Index of each pickup in Owners, for constant time registration. Keys are never dereferenced.
+	TMap<FPickupProximityKey, int32> IndexByKey;
+
+	// Largest registered radius, the grid query range
+	float MaxRadius = 0.0f;
+
+	// Spatial index of Locations, rebuilt after registrations change
+	FSpatialHashGrid Grid;
+	bool bGridDirty = false;
+
+	// Reused query result buffer
+	TArray<int32> QueryScratch;
+
+	// Pickups reached this frame, dispatched after the queries since collecting unregisters
+	TArray<TPair<FPickupProximityKey, AIntoTheFrontroomsCharacter*>> Hits;
+
+	// Pickup/character pairs touching last frame, so a pickup fires once per entry like a begin overlap.
+	// Only used as keys, never dereferenced.
+	TSet<TPair<FPickupProximityKey, const AIntoTheFrontroomsCharacter*>> PreviousHits;
+	TSet<TPair<FPickupProximityKey, const AIntoTheFrontroomsCharacter*>> CurrentHits;
+};
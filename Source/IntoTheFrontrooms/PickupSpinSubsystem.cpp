@@ -0,0 +1,111 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "PickupSpinSubsystem.h"
+#include "Components/StaticMeshComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/World.h"
+
+UPickupSpinSubsystem::UPickupSpinSubsystem()
+{
+	SpinSpeed = 90.0f;
+	ViewDistance = 5000.0f;
+}
+
+bool UPickupSpinSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UPickupSpinSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UPickupSpinSubsystem, STATGROUP_Tickables);
+}
+
+void UPickupSpinSubsystem::RegisterMesh(UStaticMeshComponent* Mesh)
+{
+	if (!Mesh || IndexByMesh.Contains(Mesh))
+		return;
+
+	IndexByMesh.Add(Mesh, Meshes.Num());
+	Meshes.Add(Mesh);
+	BaseRotations.Add(Mesh->GetRelativeRotation());
+	Locations.Add(Mesh->GetComponentLocation());
+	bGridDirty = true;
+}
+
+void UPickupSpinSubsystem::UnregisterMesh(UStaticMeshComponent* Mesh)
+{
+	int32 Index;
+	if (!IndexByMesh.RemoveAndCopyValue(Mesh, Index))
+		return;
+
+	Meshes.RemoveAtSwap(Index);
+	BaseRotations.RemoveAtSwap(Index);
+	Locations.RemoveAtSwap(Index);
+	bGridDirty = true;
+
+	// The last mesh moved into the freed slot
+	if (Meshes.IsValidIndex(Index))
+	{
+		IndexByMesh[Meshes[Index]] = Index;
+	}
+}
+
+void UPickupSpinSubsystem::Tick(float DeltaTime)
+{
+	UWorld* World = GetWorld();
+	if (Meshes.Num() == 0 || World->GetNetMode() == NM_DedicatedServer)
+		return;
+
+	SpinAngle = FMath::Fmod(SpinAngle + SpinSpeed * DeltaTime, 360.0f);
+
+	// Pickups don't move, the grid only changes when pickups come and go
+	if (bGridDirty)
+	{
+		Grid.SetCellSize(ViewDistance);
+		Grid.Reset();
+		for (int32 Index = 0; Index < Locations.Num(); ++Index)
+		{
+			Grid.Add(Index, Locations[Index]);
+		}
+		Grid.Build();
+		bGridDirty = false;
+	}
+
+	VisibleScratch.Reset();
+	int32 NumViews = 0;
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+	{
+		APlayerController* PC = It->Get();
+		if (!PC || !PC->IsLocalController())
+			continue;
+
+		FVector ViewLocation;
+		FRotator ViewRotation;
+		PC->GetPlayerViewPoint(ViewLocation, ViewRotation);
+		Grid.QueryRadius(ViewLocation, ViewDistance, VisibleScratch);
+		++NumViews;
+	}
+
+	// Split screen views can overlap, sort so duplicates are adjacent
+	if (NumViews > 1)
+	{
+		VisibleScratch.Sort();
+	}
+
+	int32 PreviousIndex = INDEX_NONE;
+	for (int32 Index : VisibleScratch)
+	{
+		if (Index == PreviousIndex)
+			continue;
+		PreviousIndex = Index;
+
+		UStaticMeshComponent* Mesh = Meshes[Index];
+		if (!IsValid(Mesh))
+			continue;
+
+		const FRotator& Base = BaseRotations[Index];
+		Mesh->SetRelativeRotation_Direct(FRotator(Base.Pitch, Base.Yaw + SpinAngle, Base.Roll));
+		Mesh->UpdateComponentToWorld(EUpdateTransformFlags::SkipPhysicsUpdate);
+	}
+}
@@ -0,0 +1,68 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SpatialHashGrid.h"
+#include "PickupSpinSubsystem.generated.h"
+
+class UStaticMeshComponent;
+
+/**
+ * Spins every registered pickup mesh in one pass instead of a Tick per pickup.
+ * Only meshes within ViewDistance of a local player are updated, through the direct
+ * relative rotation setter and a transform update that skips physics; render transforms
+ * are then sent in the engine's batched end-of-frame update. Never runs on a dedicated server.
+ */
+UCLASS(config=Game)
+class INTOTHEFRONTROOMS_API UPickupSpinSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UPickupSpinSubsystem();
+
+	// FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/** Start spinning a static pickup mesh around its current relative rotation */
+	void RegisterMesh(UStaticMeshComponent* Mesh);
+
+	/** Stop spinning a mesh, e.g. once its pickup is collected */
+	void UnregisterMesh(UStaticMeshComponent* Mesh);
+
+	/** Spin speed in degrees per second */
+	UPROPERTY(Config, BlueprintReadOnly, Category = "Pickup")
+	float SpinSpeed;
+
+	/** Meshes farther than this from every local player are left alone */
+	UPROPERTY(Config, BlueprintReadOnly, Category = "Pickup")
+	float ViewDistance;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	UPROPERTY()
+	TArray<TObjectPtr<UStaticMeshComponent>> Meshes;
+
+	// Relative rotation each mesh was registered with, matching Meshes
+	TArray<FRotator> BaseRotations;
+
+	// World location of each mesh, matching Meshes
+	TArray<FVector> Locations;
+
+	// Index of each mesh in Meshes, for constant time registration. Keys are never dereferenced.
+	TMap<const UStaticMeshComponent*, int32> IndexByMesh;
+
+	// Spatial index of Locations, rebuilt after registrations change
+	FSpatialHashGrid Grid;
+	bool bGridDirty = false;
+
+	// Yaw added to every base rotation, shared so all pickups spin in step
+	float SpinAngle = 0.0f;
+
+	// Meshes near a local player this frame
+	TArray<int32> VisibleScratch;
+};
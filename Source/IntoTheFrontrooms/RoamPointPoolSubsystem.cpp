@@ -0,0 +1,154 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "RoamPointPoolSubsystem.h"
+#include "NavigationSystem.h"
+#include "NavigationData.h"
+#include "Engine/World.h"
+
+URoamPointPoolSubsystem::URoamPointPoolSubsystem()
+{
+	// Default pool settings, overridden from Config/DefaultGame.ini
+	PointsPerRegion = 32;
+	SamplesPerFrame = 16;
+}
+
+bool URoamPointPoolSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId URoamPointPoolSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(URoamPointPoolSubsystem, STATGROUP_Tickables);
+}
+
+void URoamPointPoolSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	if (UNavigationSystemV1* NavSystem = UNavigationSystemV1::GetCurrent(&InWorld))
+	{
+		NavSystem->OnNavigationGenerationFinishedDelegate.AddUniqueDynamic(this, &URoamPointPoolSubsystem::OnNavigationGenerationFinished);
+	}
+}
+
+void URoamPointPoolSubsystem::Deinitialize()
+{
+	if (UNavigationSystemV1* NavSystem = UNavigationSystemV1::GetCurrent(GetWorld()))
+	{
+		NavSystem->OnNavigationGenerationFinishedDelegate.RemoveDynamic(this, &URoamPointPoolSubsystem::OnNavigationGenerationFinished);
+	}
+
+	Regions.Reset();
+	RegionLookup.Reset();
+
+	Super::Deinitialize();
+}
+
+int32 URoamPointPoolSubsystem::RegisterRegion(const FVector& Center, float Radius)
+{
+	// Spawn points within a meter of each other with the same radius share one pool
+	const FIntVector4 Key(
+		FMath::RoundToInt32(Center.X / 100.0f),
+		FMath::RoundToInt32(Center.Y / 100.0f),
+		FMath::RoundToInt32(Center.Z / 100.0f),
+		FMath::RoundToInt32(Radius));
+
+	if (const int32* Existing = RegionLookup.Find(Key))
+		return *Existing;
+
+	FRoamPointRegion& Region = Regions.AddDefaulted_GetRef();
+	Region.Center = Center;
+	Region.Radius = Radius;
+	Region.Points.Reserve(PointsPerRegion);
+
+	const int32 RegionId = Regions.Num() - 1;
+	RegionLookup.Add(Key, RegionId);
+	return RegionId;
+}
+
+bool URoamPointPoolSubsystem::GetRandomPoint(int32 RegionId, FVector& OutPoint) const
+{
+	if (!Regions.IsValidIndex(RegionId) || Regions[RegionId].Points.Num() == 0)
+		return false;
+
+	const TArray<FVector>& Points = Regions[RegionId].Points;
+	OutPoint = Points[FMath::RandHelper(Points.Num())];
+	return true;
+}
+
+int32 URoamPointPoolSubsystem::GetNumPoints(int32 RegionId) const
+{
+	return Regions.IsValidIndex(RegionId) ? Regions[RegionId].Points.Num() : 0;
+}
+
+void URoamPointPoolSubsystem::OnNavigationGenerationFinished(ANavigationData* NavData)
+{
+	for (FRoamPointRegion& Region : Regions)
+	{
+		Region.bStale = Region.Points.Num() > 0;
+		Region.ValidateCursor = 0;
+	}
+}
+
+void URoamPointPoolSubsystem::Tick(float DeltaTime)
+{
+	if (Regions.Num() == 0)
+		return;
+
+	// Spread the sample budget round-robin over regions that still have work
+	int32 Budget = SamplesPerFrame;
+	int32 IdleRegions = 0;
+	while (Budget > 0 && IdleRegions < Regions.Num())
+	{
+		RegionCursor = RegionCursor % Regions.Num();
+		if (ProcessRegion(Regions[RegionCursor]))
+		{
+			--Budget;
+			IdleRegions = 0;
+		}
+		else
+		{
+			++IdleRegions;
+		}
+		++RegionCursor;
+	}
+}
+
+bool URoamPointPoolSubsystem::ProcessRegion(FRoamPointRegion& Region)
+{
+	UNavigationSystemV1* NavSystem = UNavigationSystemV1::GetCurrent(GetWorld());
+	if (!NavSystem)
+		return false;
+
+	// Re-check existing points first, dropping any that fell off the changed navmesh
+	if (Region.bStale)
+	{
+		if (Region.Points.IsValidIndex(Region.ValidateCursor))
+		{
+			FNavLocation Projected;
+			if (NavSystem->ProjectPointToNavigation(Region.Points[Region.ValidateCursor], Projected, FVector(50.0f, 50.0f, 100.0f)))
+			{
+				Region.Points[Region.ValidateCursor] = Projected.Location;
+				++Region.ValidateCursor;
+			}
+			else
+			{
+				Region.Points.RemoveAtSwap(Region.ValidateCursor);
+			}
+			return true;
+		}
+		Region.bStale = false;
+	}
+
+	if (Region.Points.Num() >= PointsPerRegion)
+		return false;
+
+	// Reachable from the region center, so every pooled point can actually be walked to
+	FNavLocation ResultLocation;
+	if (NavSystem->GetRandomReachablePointInRadius(Region.Center, Region.Radius, ResultLocation))
+	{
+		Region.Points.Add(ResultLocation.Location);
+	}
+	return true;
+}
@@ -0,0 +1,83 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "RoamPointPoolSubsystem.generated.h"
+
+class ANavigationData;
+
+/** Pre-validated navmesh points around one spawn region */
+struct FRoamPointRegion
+{
+	FVector Center = FVector::ZeroVector;
+	float Radius = 0.0f;
+
+	// Reachable navmesh points within Radius of Center
+	TArray<FVector> Points;
+
+	// Next point to re-check after the navmesh changed
+	int32 ValidateCursor = 0;
+
+	// Set when the navmesh changed and existing points must be re-checked
+	bool bStale = false;
+};
+
+/**
+ * Keeps a pool of reachable navmesh points per spawn region so roam and respawn
+ * destinations are an O(1) pick instead of repeated random navmesh sampling.
+ * Pools fill a few samples per frame and are re-validated incrementally
+ * whenever navigation generation finishes.
+ */
+UCLASS(config=Game)
+class INTOTHEFRONTROOMS_API URoamPointPoolSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	URoamPointPoolSubsystem();
+
+	// USubsystem interface
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+	// FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/** Get (or create) the pool for a region. Regions with the same center and radius share a pool. */
+	int32 RegisterRegion(const FVector& Center, float Radius);
+
+	/** Pick a random pooled point, false if the region has no points yet */
+	bool GetRandomPoint(int32 RegionId, FVector& OutPoint) const;
+
+	/** Number of pooled points in a region */
+	int32 GetNumPoints(int32 RegionId) const;
+
+	/** Points kept per region */
+	UPROPERTY(Config, BlueprintReadOnly, Category = "AI|Roam Points")
+	int32 PointsPerRegion;
+
+	/** Navmesh samples or validations done per frame across all regions */
+	UPROPERTY(Config, BlueprintReadOnly, Category = "AI|Roam Points")
+	int32 SamplesPerFrame;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	// Mark every pool for re-validation after the navmesh was rebuilt
+	UFUNCTION()
+	void OnNavigationGenerationFinished(ANavigationData* NavData);
+
+	// Spend one sample on a region, returns false if there was nothing to do
+	bool ProcessRegion(FRoamPointRegion& Region);
+
+	TArray<FRoamPointRegion> Regions;
+
+	// Quantized center/radius -> region index
+	TMap<FIntVector4, int32> RegionLookup;
+
+	// Region the next Tick starts filling from
+	int32 RegionCursor = 0;
+};
@@ -0,0 +1,447 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "RoamingAIBenchmarkSubsystem.h"
+#include "RoamingAICharacter.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Engine/World.h"
+#include "NavigationSystem.h"
+#include "NavigationInvokerComponent.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+URoamingAIBenchmarkSubsystem::URoamingAIBenchmarkSubsystem()
+{
+	EnemyCounts = { 10, 50, 200, 500 };
+	WarmUpSeconds = 3.0f;
+	MeasureSeconds = 10.0f;
+	NumPlayers = 2;
+	NavMeshTimeout = 60.0f;
+	LevelHalfExtent = 5000.0f;
+	ObstacleSpacing = 1000.0f;
+}
+
+bool URoamingAIBenchmarkSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return Super::ShouldCreateSubsystem(Outer) && FParse::Param(FCommandLine::Get(), TEXT("AIBenchmark"));
+}
+
+bool URoamingAIBenchmarkSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId URoamingAIBenchmarkSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(URoamingAIBenchmarkSubsystem, STATGROUP_Tickables);
+}
+
+void URoamingAIBenchmarkSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	EnemyClass = ARoamingAICharacter::StaticClass();
+	ParseCommandLine();
+
+	// Every enemy stays a full actor so the count being measured is exact
+	if (URoamingAISubsystem* AISubsystem = GetAISubsystem())
+	{
+		AISubsystem->bUseProxyAgents = false;
+	}
+
+	BuildTestLevel();
+
+	Phase = ERoamingAIBenchmarkPhase::WaitingForNavMesh;
+	PhaseStartTime = InWorld.GetTimeSeconds();
+	UE_LOG(LogTemp, Log, TEXT("AI Benchmark: waiting for navmesh"));
+}
+
+void URoamingAIBenchmarkSubsystem::ParseCommandLine()
+{
+	const TCHAR* CommandLine = FCommandLine::Get();
+
+	FString Counts;
+	if (FParse::Value(CommandLine, TEXT("AIBenchmarkCounts="), Counts, false))
+	{
+		TArray<FString> Parts;
+		Counts.ParseIntoArray(Parts, TEXT(","));
+
+		EnemyCounts.Reset();
+		for (const FString& Part : Parts)
+		{
+			const int32 Count = FCString::Atoi(*Part);
+			if (Count > 0)
+			{
+				EnemyCounts.Add(Count);
+			}
+		}
+	}
+
+	FParse::Value(CommandLine, TEXT("AIBenchmarkSeconds="), MeasureSeconds);
+	FParse::Value(CommandLine, TEXT("AIBenchmarkPlayers="), NumPlayers);
+	NumPlayers = FMath::Max(NumPlayers, 1);
+
+	FString ClassPath;
+	if (FParse::Value(CommandLine, TEXT("AIBenchmarkEnemyClass="), ClassPath))
+	{
+		if (UClass* LoadedClass = LoadClass<ARoamingAICharacter>(nullptr, *ClassPath))
+		{
+			EnemyClass = LoadedClass;
+		}
+		else
+		{
+			UE_LOG(LogTemp, Warning, TEXT("AI Benchmark: enemy class '%s' not found, using ARoamingAICharacter"), *ClassPath);
+		}
+	}
+}
+
+AActor* URoamingAIBenchmarkSubsystem::SpawnBox(const FVector& Location, const FVector& Size)
+{
+	// The engine cube is 100 units across
+	const FTransform Transform(FRotator::ZeroRotator, Location, Size / 100.0f);
+
+	// Static mesh can only be set on a static component before it is registered
+	AStaticMeshActor* Box = GetWorld()->SpawnActorDeferred<AStaticMeshActor>(AStaticMeshActor::StaticClass(), Transform);
+	if (!Box)
+		return nullptr;
+
+	Box->GetStaticMeshComponent()->SetStaticMesh(CubeMesh);
+	Box->FinishSpawning(Transform);
+	return Box;
+}
+
+void URoamingAIBenchmarkSubsystem::BuildTestLevel()
+{
+	CubeMesh = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+	if (!CubeMesh)
+	{
+		UE_LOG(LogTemp, Error, TEXT("AI Benchmark: failed to load the engine cube mesh"));
+		return;
+	}
+
+	// Floor top sits at Z = 0
+	AActor* Floor = SpawnBox(FVector(0.0f, 0.0f, -50.0f), FVector(LevelHalfExtent * 2.0f, LevelHalfExtent * 2.0f, 100.0f));
+	if (!Floor)
+		return;
+
+	// Pillars on a jittered grid give paths and sight lines something to go around, fixed seed keeps runs comparable
+	FRandomStream Random(1337);
+	for (float X = -LevelHalfExtent + ObstacleSpacing; X < LevelHalfExtent; X += ObstacleSpacing)
+	{
+		for (float Y = -LevelHalfExtent + ObstacleSpacing; Y < LevelHalfExtent; Y += ObstacleSpacing)
+		{
+			if (Random.FRand() < 0.4f)
+				continue;
+
+			const FVector Jitter(Random.FRandRange(-0.25f, 0.25f) * ObstacleSpacing, Random.FRandRange(-0.25f, 0.25f) * ObstacleSpacing, 0.0f);
+			const FVector Size(Random.FRandRange(150.0f, 400.0f), Random.FRandRange(150.0f, 400.0f), 300.0f);
+			SpawnBox(FVector(X, Y, Size.Z * 0.5f) + Jitter, Size);
+		}
+	}
+
+	// Generate navigation around the floor, covering its corners
+	UNavigationInvokerComponent* Invoker = NewObject<UNavigationInvokerComponent>(Floor);
+	const float GenerationRadius = LevelHalfExtent * UE_SQRT_2 + 500.0f;
+	Invoker->SetGenerationRadii(GenerationRadius, GenerationRadius + 1000.0f);
+	Invoker->RegisterComponent();
+}
+
+bool URoamingAIBenchmarkSubsystem::IsNavMeshReady() const
+{
+	UNavigationSystemV1* NavSys = UNavigationSystemV1::GetCurrent(GetWorld());
+	if (!NavSys || NavSys->IsNavigationBuildInProgress())
+		return false;
+
+	// Generation may not have started yet, make sure the floor is actually covered
+	FNavLocation NavLocation;
+	return NavSys->ProjectPointToNavigation(FVector(LevelHalfExtent * 0.5f, LevelHalfExtent * 0.5f, 0.0f), NavLocation, FVector(200.0f, 200.0f, 200.0f)) &&
+		NavSys->ProjectPointToNavigation(FVector(-LevelHalfExtent * 0.5f, -LevelHalfExtent * 0.5f, 0.0f), NavLocation, FVector(200.0f, 200.0f, 200.0f));
+}
+
+void URoamingAIBenchmarkSubsystem::SpawnPlayers()
+{
+	UWorld* World = GetWorld();
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	for (int32 PlayerIndex = 0; PlayerIndex < NumPlayers; ++PlayerIndex)
+	{
+		ACharacter* Player = World->SpawnActor<ACharacter>(ACharacter::StaticClass(), FVector::ZeroVector, FRotator::ZeroRotator, SpawnParams);
+		APlayerController* Controller = World->SpawnActor<APlayerController>(APlayerController::StaticClass(), FVector::ZeroVector, FRotator::ZeroRotator, SpawnParams);
+		if (!Player || !Controller)
+			continue;
+
+		// Moved by teleporting along the orbit, no physics
+		Player->GetCharacterMovement()->DisableMovement();
+		Controller->Possess(Player);
+
+		Players.Add(Player);
+		PlayerControllers.Add(Controller);
+	}
+
+	UpdatePlayers();
+}
+
+void URoamingAIBenchmarkSubsystem::UpdatePlayers()
+{
+	const float Time = GetWorld()->GetTimeSeconds();
+	const float OrbitRadius = LevelHalfExtent * 0.6f;
+	const float OrbitSpeed = 300.0f; // Roughly walking speed
+
+	for (int32 PlayerIndex = 0; PlayerIndex < Players.Num(); ++PlayerIndex)
+	{
+		ACharacter* Player = Players[PlayerIndex];
+		if (!IsValid(Player))
+			continue;
+
+		// Players are spread evenly around the orbit, facing along it
+		const float Angle = Time * OrbitSpeed / OrbitRadius + PlayerIndex * UE_TWO_PI / Players.Num();
+		const FVector Location(FMath::Cos(Angle) * OrbitRadius, FMath::Sin(Angle) * OrbitRadius, Player->GetCapsuleComponent()->GetScaledCapsuleHalfHeight());
+		const FRotator Rotation(0.0f, FMath::RadiansToDegrees(Angle) + 90.0f, 0.0f);
+
+		Player->SetActorLocationAndRotation(Location, Rotation);
+		if (APlayerController* Controller = PlayerControllers[PlayerIndex])
+		{
+			Controller->SetControlRotation(Rotation);
+		}
+	}
+}
+
+void URoamingAIBenchmarkSubsystem::Tick(float DeltaTime)
+{
+	UWorld* World = GetWorld();
+	if (!World || !World->HasBegunPlay())
+		return;
+
+	const double Now = World->GetTimeSeconds();
+	const double RealTime = FPlatformTime::Seconds();
+	const double FrameSeconds = RealTime - LastFrameTime;
+	LastFrameTime = RealTime;
+
+	switch (Phase)
+	{
+		case ERoamingAIBenchmarkPhase::WaitingForNavMesh:
+			if (IsNavMeshReady())
+			{
+				UE_LOG(LogTemp, Log, TEXT("AI Benchmark: navmesh ready after %.1fs"), Now - PhaseStartTime);
+				SpawnPlayers();
+				StartSweep(0);
+			}
+			else if (Now - PhaseStartTime > NavMeshTimeout)
+			{
+				UE_LOG(LogTemp, Error, TEXT("AI Benchmark: navmesh not generated after %.0fs, check the navigation invoker settings"), NavMeshTimeout);
+				Finish();
+			}
+			break;
+
+		case ERoamingAIBenchmarkPhase::WarmingUp:
+			UpdatePlayers();
+			if (Now - PhaseStartTime >= WarmUpSeconds)
+			{
+				if (URoamingAISubsystem* AISubsystem = GetAISubsystem())
+				{
+					LastCounters = AISubsystem->GetPerfCounters();
+				}
+				Phase = ERoamingAIBenchmarkPhase::Measuring;
+				PhaseStartTime = Now;
+			}
+			break;
+
+		case ERoamingAIBenchmarkPhase::Measuring:
+			UpdatePlayers();
+			SampleFrame(FrameSeconds);
+			if (Now - PhaseStartTime >= MeasureSeconds)
+			{
+				FinishSweep();
+			}
+			break;
+
+		case ERoamingAIBenchmarkPhase::Done:
+			break;
+	}
+}
+
+void URoamingAIBenchmarkSubsystem::StartSweep(int32 SweepIndex)
+{
+	CurrentSweep = SweepIndex;
+	if (!EnemyCounts.IsValidIndex(SweepIndex))
+	{
+		Finish();
+		return;
+	}
+
+	UWorld* World = GetWorld();
+	UNavigationSystemV1* NavSys = UNavigationSystemV1::GetCurrent(World);
+	const int32 NumEnemies = EnemyCounts[SweepIndex];
+
+	CurrentResult = FRoamingAIBenchmarkResult();
+	CurrentResult.NumEnemies = NumEnemies;
+
+	const ARoamingAICharacter* DefaultEnemy = EnemyClass->GetDefaultObject<ARoamingAICharacter>();
+	const float HalfHeight = DefaultEnemy->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+	// Memory is sampled around the spawn loop only, controllers are included
+	const uint64 UsedMemoryBefore = FPlatformMemory::GetStats().UsedPhysical;
+
+	Enemies.Reserve(NumEnemies);
+	for (int32 EnemyIndex = 0; EnemyIndex < NumEnemies; ++EnemyIndex)
+	{
+		FNavLocation NavLocation;
+		if (!NavSys || !NavSys->GetRandomReachablePointInRadius(FVector::ZeroVector, LevelHalfExtent, NavLocation))
+			continue;
+
+		const FRotator Rotation(0.0f, FMath::FRandRange(0.0f, 360.0f), 0.0f);
+		if (ARoamingAICharacter* Enemy = World->SpawnActor<ARoamingAICharacter>(EnemyClass, NavLocation.Location + FVector(0.0f, 0.0f, HalfHeight), Rotation, SpawnParams))
+		{
+			Enemies.Add(Enemy);
+		}
+	}
+
+	const uint64 UsedMemoryAfter = FPlatformMemory::GetStats().UsedPhysical;
+	if (Enemies.Num() > 0 && UsedMemoryAfter > UsedMemoryBefore)
+	{
+		CurrentResult.MemoryPerEnemyKB = double(UsedMemoryAfter - UsedMemoryBefore) / Enemies.Num() / 1024.0;
+	}
+
+	if (Enemies.Num() < NumEnemies)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("AI Benchmark: only spawned %d of %d enemies"), Enemies.Num(), NumEnemies);
+	}
+
+	Phase = ERoamingAIBenchmarkPhase::WarmingUp;
+	PhaseStartTime = World->GetTimeSeconds();
+}
+
+void URoamingAIBenchmarkSubsystem::SampleFrame(double FrameSeconds)
+{
+	URoamingAISubsystem* AISubsystem = GetAISubsystem();
+	if (!AISubsystem)
+		return;
+
+	const FRoamingAIPerfCounters Counters = AISubsystem->GetPerfCounters();
+	const double UpdateMs = (Counters.UpdateSeconds - LastCounters.UpdateSeconds) * 1000.0;
+
+	// Sums for now, averaged in FinishSweep
+	++CurrentResult.Frames;
+	CurrentResult.FrameMs += FrameSeconds * 1000.0;
+	CurrentResult.UpdateMs += UpdateMs;
+	CurrentResult.SightMs += (Counters.SightSeconds - LastCounters.SightSeconds) * 1000.0;
+	CurrentResult.PathMs += (Counters.PathSeconds - LastCounters.PathSeconds) * 1000.0;
+	CurrentResult.RespawnMs += (Counters.RespawnSeconds - LastCounters.RespawnSeconds) * 1000.0;
+	CurrentResult.MaxUpdateMs = FMath::Max(CurrentResult.MaxUpdateMs, UpdateMs);
+	CurrentResult.Steps += Counters.Steps - LastCounters.Steps;
+	CurrentResult.PathQueries += Counters.PathQueries - LastCounters.PathQueries;
+	CurrentResult.Respawns += Counters.RespawnQueries - LastCounters.RespawnQueries;
+
+	LastCounters = Counters;
+}
+
+void URoamingAIBenchmarkSubsystem::FinishSweep()
+{
+	if (CurrentResult.Frames > 0)
+	{
+		const double InvFrames = 1.0 / CurrentResult.Frames;
+		CurrentResult.FrameMs *= InvFrames;
+		CurrentResult.UpdateMs *= InvFrames;
+		CurrentResult.SightMs *= InvFrames;
+		CurrentResult.PathMs *= InvFrames;
+		CurrentResult.RespawnMs *= InvFrames;
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("AI Benchmark: %d enemies, frame %.2fms, update %.3fms (max %.3fms), sight %.3fms, path %.3fms, respawn %.3fms, %.1fKB per enemy"),
+		CurrentResult.NumEnemies, CurrentResult.FrameMs, CurrentResult.UpdateMs, CurrentResult.MaxUpdateMs,
+		CurrentResult.SightMs, CurrentResult.PathMs, CurrentResult.RespawnMs, CurrentResult.MemoryPerEnemyKB);
+
+	Results.Add(CurrentResult);
+	DestroyEnemies();
+	StartSweep(CurrentSweep + 1);
+}
+
+void URoamingAIBenchmarkSubsystem::DestroyEnemies()
+{
+	for (ARoamingAICharacter* Enemy : Enemies)
+	{
+		if (!IsValid(Enemy))
+			continue;
+
+		AController* Controller = Enemy->GetController();
+		Enemy->Destroy();
+		if (Controller)
+		{
+			Controller->Destroy();
+		}
+	}
+	Enemies.Reset();
+}
+
+void URoamingAIBenchmarkSubsystem::WriteResults() const
+{
+	if (Results.Num() == 0)
+		return;
+
+	const FString BaseName = FPaths::ProjectSavedDir() / TEXT("Benchmarks") / FString::Printf(TEXT("AIBenchmark-%s"), *FDateTime::Now().ToString(TEXT("%Y%m%d-%H%M%S")));
+
+	FString Csv = TEXT("Enemies,Frames,FrameMs,UpdateMs,MaxUpdateMs,SightMs,PathMs,RespawnMs,Steps,PathQueries,Respawns,MemoryPerEnemyKB\n");
+	for (const FRoamingAIBenchmarkResult& Result : Results)
+	{
+		Csv += FString::Printf(TEXT("%d,%d,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%d,%d,%d,%.2f\n"),
+			Result.NumEnemies, Result.Frames, Result.FrameMs, Result.UpdateMs, Result.MaxUpdateMs,
+			Result.SightMs, Result.PathMs, Result.RespawnMs, Result.Steps, Result.PathQueries, Result.Respawns, Result.MemoryPerEnemyKB);
+	}
+
+	FString Json = TEXT("{\n");
+	Json += FString::Printf(TEXT("\t\"build\": \"%s\",\n"), FApp::GetBuildVersion());
+	Json += FString::Printf(TEXT("\t\"enemyClass\": \"%s\",\n"), *GetNameSafe(EnemyClass));
+	Json += FString::Printf(TEXT("\t\"players\": %d,\n"), Players.Num());
+	Json += FString::Printf(TEXT("\t\"measureSeconds\": %.1f,\n"), MeasureSeconds);
+	Json += TEXT("\t\"results\": [\n");
+	for (int32 ResultIndex = 0; ResultIndex < Results.Num(); ++ResultIndex)
+	{
+		const FRoamingAIBenchmarkResult& Result = Results[ResultIndex];
+		Json += FString::Printf(TEXT("\t\t{ \"enemies\": %d, \"frames\": %d, \"frameMs\": %.4f, \"updateMs\": %.4f, \"maxUpdateMs\": %.4f, \"sightMs\": %.4f, \"pathMs\": %.4f, \"respawnMs\": %.4f, \"steps\": %d, \"pathQueries\": %d, \"respawns\": %d, \"memoryPerEnemyKB\": %.2f }%s\n"),
+			Result.NumEnemies, Result.Frames, Result.FrameMs, Result.UpdateMs, Result.MaxUpdateMs,
+			Result.SightMs, Result.PathMs, Result.RespawnMs, Result.Steps, Result.PathQueries, Result.Respawns, Result.MemoryPerEnemyKB,
+			ResultIndex + 1 < Results.Num() ? TEXT(",") : TEXT(""));
+	}
+	Json += TEXT("\t]\n}\n");
+
+	if (FFileHelper::SaveStringToFile(Csv, *(BaseName + TEXT(".csv"))) && FFileHelper::SaveStringToFile(Json, *(BaseName + TEXT(".json"))))
+	{
+		UE_LOG(LogTemp, Log, TEXT("AI Benchmark: results written to %s.csv/.json"), *BaseName);
+	}
+	else
+	{
+		UE_LOG(LogTemp, Error, TEXT("AI Benchmark: failed to write results to %s"), *BaseName);
+	}
+}
+
+void URoamingAIBenchmarkSubsystem::Finish()
+{
+	Phase = ERoamingAIBenchmarkPhase::Done;
+	DestroyEnemies();
+	WriteResults();
+
+	// Leave PIE sessions running, standalone runs are scripted and should exit
+	if (!GIsEditor)
+	{
+		FPlatformMisc::RequestExit(false);
+	}
+}
+
+URoamingAISubsystem* URoamingAIBenchmarkSubsystem::GetAISubsystem() const
+{
+	UWorld* World = GetWorld();
+	return World ? World->GetSubsystem<URoamingAISubsystem>() : nullptr;
+}
@@ -0,0 +1,164 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "RoamingAISubsystem.h"
+#include "RoamingAIBenchmarkSubsystem.generated.h"
+
+class ACharacter;
+class APlayerController;
+class ARoamingAICharacter;
+class UStaticMesh;
+
+/** Averages measured for one enemy count */
+struct FRoamingAIBenchmarkResult
+{
+	int32 NumEnemies = 0;
+	int32 Frames = 0;
+
+	// Average per frame (milliseconds)
+	double FrameMs = 0.0;
+	double UpdateMs = 0.0;
+	double SightMs = 0.0;
+	double PathMs = 0.0;
+	double RespawnMs = 0.0;
+
+	// Worst single frame of the AI update (milliseconds)
+	double MaxUpdateMs = 0.0;
+
+	int32 Steps = 0;
+	int32 PathQueries = 0;
+	int32 Respawns = 0;
+
+	// Used physical memory growth from spawning, divided by the enemy count
+	double MemoryPerEnemyKB = 0.0;
+};
+
+UENUM()
+enum class ERoamingAIBenchmarkPhase : uint8
+{
+	WaitingForNavMesh,
+	WarmingUp,
+	Measuring,
+	Done
+};
+
+/**
+ * Headless AI stress benchmark, only created when the game runs with -AIBenchmark.
+ * Builds a procedural floor with obstacles, waits for the navmesh around it, then for
+ * every enemy count spawns that many roaming enemies next to a few orbiting fake players
+ * and records the per-frame cost of the AI update, sight, pathing and respawns plus the
+ * memory each enemy adds. Results are written as CSV and JSON to Saved/Benchmarks.
+ *
+ * The level has no navmesh bounds, generation runs around a navigation invoker on the floor:
+ *   UnrealEditor-Cmd IntoTheFrontrooms.uproject /Engine/Maps/Entry -game -nullrhi -unattended -AIBenchmark
+ *     -ini:Engine:[/Script/NavigationSystem.RecastNavMesh]:RuntimeGeneration=Dynamic
+ *     -ini:Engine:[/Script/NavigationSystem.NavigationSystemV1]:bGenerateNavigationOnlyAroundNavigationInvokers=True
+ *
+ * Optional: -AIBenchmarkCounts=10,50,200,500 -AIBenchmarkSeconds=10 -AIBenchmarkPlayers=2
+ *           -AIBenchmarkEnemyClass=/Game/Path/BP_Enemy.BP_Enemy_C
+ */
+UCLASS()
+class INTOTHEFRONTROOMS_API URoamingAIBenchmarkSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	URoamingAIBenchmarkSubsystem();
+
+	// USubsystem interface
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	// FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/** Enemy counts swept, in order */
+	TArray<int32> EnemyCounts;
+
+	/** Seconds each count runs before measuring starts */
+	float WarmUpSeconds;
+
+	/** Seconds measured per count */
+	float MeasureSeconds;
+
+	/** Simulated players orbiting the level */
+	int32 NumPlayers;
+
+	/** Give up if the navmesh is not ready after this long (seconds) */
+	float NavMeshTimeout;
+
+	/** Half size of the generated floor */
+	float LevelHalfExtent;
+
+	/** Distance between obstacle pillars */
+	float ObstacleSpacing;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	// Read overrides from the command line
+	void ParseCommandLine();
+
+	// Spawn the floor, obstacles and navigation invoker
+	void BuildTestLevel();
+
+	// Spawn a static cube scaled to Size (full extents) centered on Location
+	AActor* SpawnBox(const FVector& Location, const FVector& Size);
+
+	bool IsNavMeshReady() const;
+
+	void SpawnPlayers();
+
+	// Move the fake players along their orbits
+	void UpdatePlayers();
+
+	void StartSweep(int32 SweepIndex);
+	void FinishSweep();
+	void DestroyEnemies();
+
+	// Record this frame's share of the AI counters
+	void SampleFrame(double FrameSeconds);
+
+	void WriteResults() const;
+
+	// End the run, exits when running standalone
+	void Finish();
+
+	URoamingAISubsystem* GetAISubsystem() const;
+
+	ERoamingAIBenchmarkPhase Phase = ERoamingAIBenchmarkPhase::WaitingForNavMesh;
+
+	// World time the current phase started
+	double PhaseStartTime = 0.0;
+
+	// Real time of the previous tick, for frame times
+	double LastFrameTime = 0.0;
+
+	int32 CurrentSweep = INDEX_NONE;
+
+	TSubclassOf<ARoamingAICharacter> EnemyClass;
+
+	UPROPERTY()
+	TObjectPtr<UStaticMesh> CubeMesh;
+
+	UPROPERTY()
+	TArray<TObjectPtr<ARoamingAICharacter>> Enemies;
+
+	UPROPERTY()
+	TArray<TObjectPtr<ACharacter>> Players;
+
+	UPROPERTY()
+	TArray<TObjectPtr<APlayerController>> PlayerControllers;
+
+	// AI counters at the previous sample
+	FRoamingAIPerfCounters LastCounters;
+
+	// Result being measured for the current sweep
+	FRoamingAIBenchmarkResult CurrentResult;
+
+	TArray<FRoamingAIBenchmarkResult> Results;
+};
@@ -2,20 +2,46 @@
 
 #include "RoamingAICharacter.h"
 #include "GameFramework/CharacterMovementComponent.h"
+#include "Components/CapsuleComponent.h"
+#include "SkeletalMeshComponentBudgeted.h"
 #include "Kismet/GameplayStatics.h"
-#include "Particles/ParticleSystemComponent.h"
-#include "NiagaraFunctionLibrary.h"
-#include "NiagaraComponent.h"
+#include "Particles/ParticleSystem.h"
+#include "NiagaraSystem.h"
 #include "NavigationSystem.h"
 #include "TimerManager.h"
+#include "EffectPoolSubsystem.h"
 #include "AIController.h"
+#include "RoamingAIController.h"
+#include "RoamPointPoolSubsystem.h"
+#include "RoamingAISubsystem.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/PlayerState.h"
+#include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
 
-ARoamingAICharacter::ARoamingAICharacter()
+ARoamingAICharacter::ARoamingAICharacter(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer.SetDefaultSubobjectClass<USkeletalMeshComponentBudgeted>(ACharacter::MeshComponentName))
 {
-	PrimaryActorTick.bCanEverTick = false; // Controller handles all AI logic
+	// AI logic runs in URoamingAISubsystem, the actor only ticks on clients to interpolate (see BeginPlay)
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+
+	// Clients get the compact FRoamingAIReplicatedState instead of full-rate movement replication
+	bReplicates = true;
+	SetReplicatingMovement(false);
+
+	// Enemy animation runs under the animation budget allocator (a.Budget.* in DefaultEngine.ini),
+	// which throttles and interpolates less significant meshes. Significance comes from the distance
+	// to the nearest view. Off-screen meshes only tick montages.
+	USkeletalMeshComponentBudgeted* MeshComp = CastChecked<USkeletalMeshComponentBudgeted>(GetMesh());
+	MeshComp->SetAutoCalculateSignificance(true);
+	MeshComp->bEnableUpdateRateOptimizations = true;
+	MeshComp->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::OnlyTickMontagesWhenNotRendered;
 
 	// Default AI settings
 	SightRange = 1500.0f;
+	SightHalfAngle = 180.0f; // No cone by default
+	MaxSightHeightDifference = 800.0f;
 	RoamingSpeed = 200.0f;
 	ChaseSpeed = 400.0f;
 	MaxRoamDistance = 1000.0f;
@@ -34,6 +60,19 @@ ARoamingAICharacter::ARoamingAICharacter()
 	DespawnSmokeLifetime = 2.0f; // Smoke lasts 2 seconds by default
 	DespawnSound = nullptr;
 	LastAttackTime = -999.0f; // Can attack immediately
+	RoamRegionId = INDEX_NONE;
+	bRespawnPending = false;
+	bIsProxy = false;
+	bInPool = false;
+	bAllowProxyRepresentation = false;
+
+	// Default network settings
+	WaitingNetUpdateFrequency = 2.0f;
+	RoamingNetUpdateFrequency = 10.0f;
+	ChasingNetUpdateFrequency = 30.0f;
+	NetInterpolationSpeed = 10.0f;
+	MaxNetExtrapolationTime = 0.25f;
+	LastReplicatedStateTime = 0.0;
 
 	// Configure character movement
 	GetCharacterMovement()->MaxWalkSpeed = RoamingSpeed;
@@ -45,14 +84,288 @@ ARoamingAICharacter::ARoamingAICharacter()
 void ARoamingAICharacter::BeginPlay()
 {
 	Super::BeginPlay();
-	
+
+	if (HasAuthority())
+	{
+		ReplicatedAIState.Location = GetActorLocation();
+		ReplicatedAIState.Yaw = FRotator::CompressAxisToByte(GetActorRotation().Yaw);
+		ApplyNetUpdateFrequency(ReplicatedAIState.State);
+	}
+	else
+	{
+		// Movement comes from the replicated state, the movement component only carries velocity for animation
+		GetCharacterMovement()->SetComponentTickEnabled(false);
+		SetActorTickEnabled(true);
+		LastReplicatedStateTime = GetWorld()->GetTimeSeconds();
+	}
+
+	// Shared by every enemy using the same smoke, prewarming only tops the pool up
+	if (UEffectPoolSubsystem* Effects = UWorld::GetSubsystem<UEffectPoolSubsystem>(GetWorld()))
+	{
+		Effects->Prewarm(GetDespawnSmokeEffect());
+	}
+
+	// Pooled enemies get their spawn location when they are handed out
+	if (bInPool)
+	{
+		SetPooledActive(false);
+		return;
+	}
+
 	// Store spawn location for roaming reference and respawning
 	SpawnLocation = GetActorLocation();
+
+	RegisterRoamRegion();
+}
+
+UFXSystemAsset* ARoamingAICharacter::GetDespawnSmokeEffect() const
+{
+	// Prefer Niagara (UE5) over Cascade (legacy)
+	if (DespawnSmokeEffectNiagara)
+		return DespawnSmokeEffectNiagara;
+
+	return DespawnSmokeEffectCascade;
+}
+
+void ARoamingAICharacter::RegisterRoamRegion()
+{
+	// Start filling the roam point pool for this spawn region (AI only runs on the server)
+	if (!HasAuthority())
+		return;
+
+	if (URoamPointPoolSubsystem* RoamPoints = UWorld::GetSubsystem<URoamPointPoolSubsystem>(GetWorld()))
+	{
+		RoamRegionId = RoamPoints->RegisterRegion(SpawnLocation, MaxRoamDistance);
+	}
+}
+
+void ARoamingAICharacter::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+	DOREPLIFETIME_WITH_PARAMS_FAST(ARoamingAICharacter, ReplicatedAIState, Params);
+}
+
+void ARoamingAICharacter::UpdateReplicatedAIState(EAIState State, const ACharacter* TargetPlayer)
+{
+	const APlayerState* TargetState = TargetPlayer ? TargetPlayer->GetPlayerState() : nullptr;
+
+	// Quantize before comparing so sub-unit jitter does not dirty the property
+	FRoamingAIReplicatedState NewState = ReplicatedAIState;
+	NewState.State = State;
+	NewState.TargetPlayerId = TargetState ? TargetState->GetPlayerId() : INDEX_NONE;
+	NewState.Location = GetActorLocation().GridSnap(1.0f);
+	NewState.Velocity = GetVelocity().GridSnap(0.1f);
+	NewState.Yaw = FRotator::CompressAxisToByte(GetActorRotation().Yaw);
+
+	if (NewState == ReplicatedAIState)
+		return;
+
+	const bool bStateChanged = NewState.State != ReplicatedAIState.State;
+	ReplicatedAIState = NewState;
+	MARK_PROPERTY_DIRTY_FROM_NAME(ARoamingAICharacter, ReplicatedAIState, this);
+
+	if (bStateChanged)
+	{
+		ApplyNetUpdateFrequency(State);
+		ForceNetUpdate(); // Send the transition right away even at the old rate
+		OnAIStateChanged(State);
+	}
+}
+
+void ARoamingAICharacter::MarkTeleported()
+{
+	++ReplicatedAIState.TeleportCount;
+	ReplicatedAIState.Location = GetActorLocation();
+	ReplicatedAIState.Velocity = FVector::ZeroVector;
+	MARK_PROPERTY_DIRTY_FROM_NAME(ARoamingAICharacter, ReplicatedAIState, this);
+}
+
+void ARoamingAICharacter::ApplyNetUpdateFrequency(EAIState State)
+{
+	switch (State)
+	{
+		case EAIState::Waiting:
+			SetNetUpdateFrequency(WaitingNetUpdateFrequency);
+			break;
+
+		case EAIState::Chasing:
+			SetNetUpdateFrequency(ChasingNetUpdateFrequency);
+			break;
+
+		default:
+			SetNetUpdateFrequency(RoamingNetUpdateFrequency);
+			break;
+	}
+}
+
+void ARoamingAICharacter::OnRep_ReplicatedAIState(const FRoamingAIReplicatedState& PreviousState)
+{
+	LastReplicatedStateTime = GetWorld()->GetTimeSeconds();
+
+	if (ReplicatedAIState.TeleportCount != PreviousState.TeleportCount)
+	{
+		const FRotator Rotation(0.0f, FRotator::DecompressAxisFromByte(ReplicatedAIState.Yaw), 0.0f);
+		SetActorLocationAndRotation(ReplicatedAIState.Location, Rotation, false, nullptr, ETeleportType::TeleportPhysics);
+	}
+
+	// Animation blueprints read the movement component velocity
+	GetCharacterMovement()->Velocity = ReplicatedAIState.Velocity;
+
+	if (ReplicatedAIState.State != PreviousState.State)
+	{
+		OnAIStateChanged(ReplicatedAIState.State);
+	}
+}
+
+void ARoamingAICharacter::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// Clients only, the server moves the character through the movement component
+	if (HasAuthority() || IsHidden())
+		return;
+
+	// Extrapolate along the replicated velocity for a short while and converge on that point
+	const float Age = FMath::Min(float(GetWorld()->GetTimeSeconds() - LastReplicatedStateTime), MaxNetExtrapolationTime);
+	const FVector TargetLocation = ReplicatedAIState.Location + ReplicatedAIState.Velocity * Age;
+	const FRotator TargetRotation(0.0f, FRotator::DecompressAxisFromByte(ReplicatedAIState.Yaw), 0.0f);
+
+	SetActorLocationAndRotation(
+		FMath::VInterpTo(GetActorLocation(), TargetLocation, DeltaTime, NetInterpolationSpeed),
+		FMath::RInterpTo(GetActorRotation(), TargetRotation, DeltaTime, NetInterpolationSpeed));
+}
+
+ACharacter* ARoamingAICharacter::GetChaseTarget() const
+{
+	if (ReplicatedAIState.TargetPlayerId == INDEX_NONE)
+		return nullptr;
+
+	const AGameStateBase* GameState = GetWorld()->GetGameState();
+	if (!GameState)
+		return nullptr;
+
+	for (const APlayerState* PlayerState : GameState->PlayerArray)
+	{
+		if (PlayerState && PlayerState->GetPlayerId() == ReplicatedAIState.TargetPlayerId)
+			return Cast<ACharacter>(PlayerState->GetPawn());
+	}
+	return nullptr;
+}
+
+void ARoamingAICharacter::InitializeForPool()
+{
+	bInPool = true;
+}
+
+void ARoamingAICharacter::DeactivateForPool()
+{
+	bInPool = true;
+	bRespawnPending = false; // Any respawn query in flight is dropped
+	GetWorldTimerManager().ClearAllTimersForObject(this);
+	SetPooledActive(false);
+
+	// A parked proxy handed to the pool stops being one, the subsystem drops its proxy entry
+	if (bIsProxy)
+	{
+		bIsProxy = false;
+		SetNetDormancy(DORM_Awake);
+	}
+
+	if (ARoamingAIController* AICtrl = Cast<ARoamingAIController>(GetController()))
+	{
+		AICtrl->StopMovement();
+		AICtrl->UnregisterFromSubsystem();
+	}
+}
+
+void ARoamingAICharacter::ActivateFromPool(const FVector& Location, const FRotator& Rotation)
+{
+	bInPool = false;
+	bRespawnPending = false;
+	LastAttackTime = -999.0f; // Can attack immediately
+
+	SpawnLocation = Location;
+	SetActorLocationAndRotation(Location, Rotation, false, nullptr, ETeleportType::ResetPhysics);
+	MarkTeleported();
+	RegisterRoamRegion();
+	SetPooledActive(true);
+
+	if (ARoamingAIController* AICtrl = Cast<ARoamingAIController>(GetController()))
+	{
+		AICtrl->SetControlRotation(Rotation);
+		AICtrl->RegisterWithSubsystem();
+	}
+}
+
+void ARoamingAICharacter::SetPooledActive(bool bActive)
+{
+	SetActorHiddenInGame(!bActive);
+	SetActorEnableCollision(bActive);
+
+	// The budgeted mesh forwards this to the animation budget allocator
+	GetMesh()->SetComponentTickEnabled(bActive);
+
+	UCharacterMovementComponent* Movement = GetCharacterMovement();
+	Movement->StopMovementImmediately();
+	Movement->SetComponentTickEnabled(bActive);
+	if (bActive)
+	{
+		Movement->SetMovementMode(MOVE_Walking);
+	}
+	else
+	{
+		Movement->DisableMovement();
+	}
+}
+
+void ARoamingAICharacter::EnterProxy()
+{
+	bIsProxy = true;
+	SetPooledActive(false);
+
+	if (ARoamingAIController* AICtrl = Cast<ARoamingAIController>(GetController()))
+	{
+		AICtrl->StopMovement();
+		AICtrl->UnregisterFromSubsystem();
+	}
+
+	// Send the hidden state once, then stay off the wire until promoted
+	ForceNetUpdate();
+	SetNetDormancy(DORM_DormantAll);
+}
+
+void ARoamingAICharacter::ExitProxy(const FVector& Location, float Yaw)
+{
+	bIsProxy = false;
+	SetNetDormancy(DORM_Awake);
+
+	const FRotator Rotation(0.0f, Yaw, 0.0f);
+	SetActorLocationAndRotation(Location, Rotation, false, nullptr, ETeleportType::ResetPhysics);
+	MarkTeleported();
+	SetPooledActive(true);
+
+	if (ARoamingAIController* AICtrl = Cast<ARoamingAIController>(GetController()))
+	{
+		AICtrl->SetControlRotation(Rotation);
+		AICtrl->RegisterWithSubsystem();
+	}
+}
+
+bool ARoamingAICharacter::GetRandomPooledRoamPoint(FVector& OutLocation) const
+{
+	if (RoamRegionId == INDEX_NONE)
+		return false;
+
+	const URoamPointPoolSubsystem* RoamPoints = UWorld::GetSubsystem<URoamPointPoolSubsystem>(GetWorld());
+	return RoamPoints && RoamPoints->GetRandomPoint(RoamRegionId, OutLocation);
 }
 
 bool ARoamingAICharacter::TryAttackPlayer(ACharacter* Player)
 {
-	if (!Player)
+	if (!Player || bRespawnPending)
 		return false;
 
 	// Check if we can attack (cooldown)
@@ -95,181 +408,110 @@ void ARoamingAICharacter::RespawnWithEffects()
 	FVector DespawnLocation = GetActorLocation();
 	FRotator DespawnRotation = GetActorRotation();
 
-	// Spawn smoke effect at current location
-	// Prefer Niagara (UE5) over Cascade (legacy)
-	if (DespawnSmokeEffectNiagara)
+	// Smoke and sound come from pools, the smoke returns itself when it finishes
+	if (UEffectPoolSubsystem* Effects = UWorld::GetSubsystem<UEffectPoolSubsystem>(World))
 	{
-		// Use modern Niagara system
-		UNiagaraComponent* SmokeComponent = UNiagaraFunctionLibrary::SpawnSystemAtLocation(
-			World,
-			DespawnSmokeEffectNiagara,
-			DespawnLocation,
-			DespawnRotation,
-			FVector(DespawnSmokeScale), // Scale
-			true, // Auto destroy
-			true, // Auto activate
-			ENCPoolMethod::None,
-			true // Pre-cull check
-		);
-
-		// Force destroy after specified lifetime if still exists (safety net)
-		if (SmokeComponent)
-		{
-			// Set up timer to forcefully destroy if needed
-			FTimerHandle DestroyTimerHandle;
-			World->GetTimerManager().SetTimer(
-				DestroyTimerHandle,
-				[SmokeComponent]()
-				{
-					if (SmokeComponent && IsValid(SmokeComponent))
-					{
-						SmokeComponent->DestroyComponent();
-					}
-				},
-				DespawnSmokeLifetime, // Use configurable lifetime
-				false // Don't loop
-			);
-		}
+		Effects->SpawnEffectAtLocation(GetDespawnSmokeEffect(), DespawnLocation, DespawnRotation, FVector(DespawnSmokeScale), DespawnSmokeLifetime);
+		Effects->PlaySoundAtLocation(DespawnSound, DespawnLocation);
 	}
-	else if (DespawnSmokeEffectCascade)
+
+	if (bRespawnAtSpawnPoint)
 	{
-		// Fallback to legacy Cascade system
-		UParticleSystemComponent* SmokeComponent = UGameplayStatics::SpawnEmitterAtLocation(
-			World,
-			DespawnSmokeEffectCascade,
-			DespawnLocation,
-			DespawnRotation,
-			FVector(DespawnSmokeScale), // Use configurable scale
-			true, // Auto destroy - this handles auto-destruction
-			EPSCPoolMethod::None,
-			true // Auto activate
-		);
-
-		// Force destroy after specified lifetime if still exists (safety net)
-		if (SmokeComponent)
-		{
-			// Set up timer to forcefully destroy if needed
-			FTimerHandle DestroyTimerHandle;
-			World->GetTimerManager().SetTimer(
-				DestroyTimerHandle,
-				[SmokeComponent]()
-				{
-					if (SmokeComponent && IsValid(SmokeComponent))
-					{
-						SmokeComponent->DestroyComponent();
-					}
-				},
-				DespawnSmokeLifetime, // Use configurable lifetime
-				false // Don't loop
-			);
-		}
+		// Respawn at original spawn point
+		CompleteRespawn(GetSpawnFeetLocation());
+		return;
 	}
 
-	// Play despawn sound
-	if (DespawnSound)
+	// Hide until the respawn query has picked a site out of every player's view
+	bRespawnPending = true;
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+	GetCharacterMovement()->DisableMovement(); // Don't fall while collision is off
+
+	if (AAIController* AICtrl = Cast<AAIController>(GetController()))
 	{
-		UGameplayStatics::PlaySoundAtLocation(
-			World,
-			DespawnSound,
-			DespawnLocation,
-			1.0f, // Volume
-			1.0f, // Pitch
-			0.0f, // Start time
-			nullptr, // Attenuation
-			nullptr, // Concurrency
-			nullptr  // Owner
-		);
+		AICtrl->StopMovement();
 	}
 
-	// Determine respawn location
-	FVector RespawnLocation;
-	bool bFoundValidLocation = false;
-	
-	if (bRespawnAtSpawnPoint)
+	if (URoamingAISubsystem* AISubsystem = UWorld::GetSubsystem<URoamingAISubsystem>(World))
 	{
-		// Respawn at original spawn point
-		RespawnLocation = SpawnLocation;
-		bFoundValidLocation = true;
+		AISubsystem->RequestRespawn(this);
+		return;
 	}
-	else
+
+	// No subsystem to run the query, pick a site right away
+	FVector RespawnLocation;
+	if (!FindRandomRespawnLocation(RespawnLocation))
 	{
-		// Try to find a valid random roaming location
-		UNavigationSystemV1* NavSystem = UNavigationSystemV1::GetCurrent(World);
-		if (NavSystem)
-		{
-			FNavLocation ResultLocation;
-			
-			// Try multiple times to find a valid location
-			const int32 MaxAttempts = 5;
-			for (int32 Attempt = 0; Attempt < MaxAttempts; ++Attempt)
-			{
-				bool bSuccess = NavSystem->GetRandomPointInNavigableRadius(
-					SpawnLocation,
-					MaxRoamDistance,
-					ResultLocation
-				);
-
-				if (bSuccess)
-				{
-					// Verify the location is actually on navmesh
-					FNavLocation ProjectedLocation;
-					if (NavSystem->ProjectPointToNavigation(ResultLocation.Location, ProjectedLocation, FVector(500.0f, 500.0f, 500.0f)))
-					{
-						RespawnLocation = ProjectedLocation.Location;
-						bFoundValidLocation = true;
-						break;
-					}
-				}
-			}
-			
-			// If random location failed, try from current location
-			if (!bFoundValidLocation)
-			{
-				if (NavSystem->GetRandomPointInNavigableRadius(
-					GetActorLocation(),
-					MaxRoamDistance * 0.5f,
-					ResultLocation))
-				{
-					FNavLocation ProjectedLocation;
-					if (NavSystem->ProjectPointToNavigation(ResultLocation.Location, ProjectedLocation, FVector(500.0f, 500.0f, 500.0f)))
-					{
-						RespawnLocation = ProjectedLocation.Location;
-						bFoundValidLocation = true;
-					}
-				}
-			}
-		}
-		
 		// Final fallback to spawn point if all else fails
-		if (!bFoundValidLocation)
-		{
-			RespawnLocation = SpawnLocation;
-		}
+		RespawnLocation = GetSpawnFeetLocation();
 	}
+	CompleteRespawn(RespawnLocation);
+}
+
+void ARoamingAICharacter::CompleteRespawn(const FVector& RespawnLocation)
+{
+	// Teleport to respawn location, standing on it like promoted and pooled enemies
+	const FVector Location = RespawnLocation + FVector(0.0f, 0.0f, GetCapsuleComponent()->GetScaledCapsuleHalfHeight());
+	SetActorLocation(Location, false, nullptr, ETeleportType::TeleportPhysics);
+	MarkTeleported();
 
-	// Teleport to respawn location
-	SetActorLocation(RespawnLocation, false, nullptr, ETeleportType::TeleportPhysics);
+	if (bRespawnPending)
+	{
+		bRespawnPending = false;
+		SetActorHiddenInGame(false);
+		SetActorEnableCollision(true);
+		GetCharacterMovement()->SetMovementMode(MOVE_Walking);
+	}
 
-	// Reset AI controller state after respawn
+	// Reset AI controller state after respawn, a new destination is picked on its next update
 	if (AAIController* AICtrl = Cast<AAIController>(GetController()))
 	{
-		// Stop any current movement
 		AICtrl->StopMovement();
-		
-		// Give AI a moment to settle at new location before starting new movement
-		// This prevents immediate path failures
-		FTimerHandle SettleTimerHandle;
-		World->GetTimerManager().SetTimer(
-			SettleTimerHandle,
-			[AICtrl]()
+	}
+}
+
+FVector ARoamingAICharacter::GetSpawnFeetLocation() const
+{
+	return SpawnLocation - FVector(0.0f, 0.0f, GetCapsuleComponent()->GetScaledCapsuleHalfHeight());
+}
+
+bool ARoamingAICharacter::FindRandomRespawnLocation(FVector& OutLocation) const
+{
+	UNavigationSystemV1* NavSystem = UNavigationSystemV1::GetCurrent(GetWorld());
+	if (!NavSystem)
+		return false;
+
+	FNavLocation ResultLocation;
+
+	// Try multiple times to find a valid location
+	const int32 MaxAttempts = 5;
+	for (int32 Attempt = 0; Attempt < MaxAttempts; ++Attempt)
+	{
+		if (NavSystem->GetRandomPointInNavigableRadius(SpawnLocation, MaxRoamDistance, ResultLocation))
+		{
+			// Verify the location is actually on navmesh
+			FNavLocation ProjectedLocation;
+			if (NavSystem->ProjectPointToNavigation(ResultLocation.Location, ProjectedLocation, FVector(500.0f, 500.0f, 500.0f)))
 			{
-				// AI can now start moving again
-				// The controller will pick a new destination on next tick
-			},
-			0.1f, // Wait 0.1 seconds to settle
-			false
-		);
+				OutLocation = ProjectedLocation.Location;
+				return true;
+			}
+		}
 	}
+
+	// If random location failed, try from current location
+	if (NavSystem->GetRandomPointInNavigableRadius(GetActorLocation(), MaxRoamDistance * 0.5f, ResultLocation))
+	{
+		FNavLocation ProjectedLocation;
+		if (NavSystem->ProjectPointToNavigation(ResultLocation.Location, ProjectedLocation, FVector(500.0f, 500.0f, 500.0f)))
+		{
+			OutLocation = ProjectedLocation.Location;
+			return true;
+		}
+	}
+
+	return false;
 }
 
 bool ARoamingAICharacter::CanAttack() const
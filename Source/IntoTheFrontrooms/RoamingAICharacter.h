@@ -4,8 +4,49 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
+#include "Engine/NetSerialization.h"
+#include "RoamingAIController.h"
 #include "RoamingAICharacter.generated.h"
 
+class UFXSystemAsset;
+
+/** Compact AI state replicated to clients in place of full movement replication */
+USTRUCT(BlueprintType)
+struct FRoamingAIReplicatedState
+{
+	GENERATED_BODY()
+
+	/** Behavior state, mirrored from the server-only controller */
+	UPROPERTY(BlueprintReadOnly, Category = "AI")
+	EAIState State = EAIState::Roaming;
+
+	/** PlayerId of the chased player's PlayerState, INDEX_NONE when not chasing */
+	UPROPERTY(BlueprintReadOnly, Category = "AI")
+	int32 TargetPlayerId = INDEX_NONE;
+
+	/** Actor location rounded to whole units */
+	UPROPERTY(BlueprintReadOnly, Category = "AI")
+	FVector_NetQuantize Location;
+
+	/** Velocity to one decimal, used to extrapolate between updates */
+	UPROPERTY(BlueprintReadOnly, Category = "AI")
+	FVector_NetQuantize10 Velocity;
+
+	/** Actor yaw compressed to a byte */
+	UPROPERTY()
+	uint8 Yaw = 0;
+
+	/** Bumped on respawn teleports so clients snap instead of interpolating across the map */
+	UPROPERTY()
+	uint8 TeleportCount = 0;
+
+	bool operator==(const FRoamingAIReplicatedState& Other) const
+	{
+		return State == Other.State && TargetPlayerId == Other.TargetPlayerId && Location == Other.Location &&
+			Velocity == Other.Velocity && Yaw == Other.Yaw && TeleportCount == Other.TeleportCount;
+	}
+};
+
 /**
  * AI Character that roams and chases the player
  */
@@ -15,7 +56,7 @@ class INTOTHEFRONTROOMS_API ARoamingAICharacter : public ACharacter
 	GENERATED_BODY()
 
 public:
-	ARoamingAICharacter();
+	ARoamingAICharacter(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
 
 	// AI Settings
 	
@@ -23,6 +64,14 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI Settings")
 	float SightRange;
 
+	/** Half angle of the view cone in degrees while not chasing (180 = sees all around) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI Settings", meta = (ClampMin = "1.0", ClampMax = "180.0"))
+	float SightHalfAngle;
+
+	/** Players whose eye height differs by more than this are never traced (e.g. another floor) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI Settings", meta = (ClampMin = "0.0"))
+	float MaxSightHeightDifference;
+
 	/** How fast the AI moves when roaming */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI Settings")
 	float RoamingSpeed;
@@ -73,7 +122,7 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI Attack|Effects", meta = (ClampMin = "0.5", ClampMax = "5.0"))
 	float DespawnSmokeScale;
 
-	/** How long the smoke effect stays before being destroyed (in seconds) */
+	/** Longest the smoke effect may play before it is stopped and returned to the effect pool (in seconds) */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI Attack|Effects", meta = (ClampMin = "0.5", ClampMax = "5.0"))
 	float DespawnSmokeLifetime;
 
@@ -85,30 +134,157 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI Attack")
 	bool bRespawnAtSpawnPoint;
 
+	/** Far from every player this enemy may be parked (hidden, dormant, without movement or animation) and simulated
+	 *  as a lightweight proxy until a player comes near. The actor and controller are kept, so nothing is lost. Opt-in. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI Settings")
+	bool bAllowProxyRepresentation;
+
+	// Network Settings
+
+	/** Net update frequency while waiting at a roam destination */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI Network", meta = (ClampMin = "0.5"))
+	float WaitingNetUpdateFrequency;
+
+	/** Net update frequency while roaming */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI Network", meta = (ClampMin = "0.5"))
+	float RoamingNetUpdateFrequency;
+
+	/** Net update frequency while chasing */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI Network", meta = (ClampMin = "0.5"))
+	float ChasingNetUpdateFrequency;
+
+	/** How quickly clients converge on the replicated location */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI Network", meta = (ClampMin = "1.0"))
+	float NetInterpolationSpeed;
+
+	/** Longest clients extrapolate along the replicated velocity without a new update (seconds) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI Network", meta = (ClampMin = "0.0"))
+	float MaxNetExtrapolationTime;
+
 	// Functions
 
 	/** Attempt to attack the player if in range */
 	UFUNCTION(BlueprintCallable, Category = "AI")
 	bool TryAttackPlayer(ACharacter* Player);
 
-	/** Respawn AI with effects at spawn point or random location */
+	/** Respawn AI with effects at spawn point or random location.
+	 *  Random locations are picked over the next frames by an off-screen respawn query. */
 	UFUNCTION(BlueprintCallable, Category = "AI")
 	void RespawnWithEffects();
 
+	/** True while hidden and waiting for the respawn query to pick a site */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "AI")
+	bool IsRespawning() const { return bRespawnPending; }
+
+	/** Teleport to the chosen respawn site (a navmesh location, the capsule is placed standing on it) and become visible again */
+	void CompleteRespawn(const FVector& RespawnLocation);
+
+	/** Synchronously sample a random navmesh location around the spawn point, used when no pooled site is available */
+	bool FindRandomRespawnLocation(FVector& OutLocation) const;
+
 	/** Get the spawn location */
 	UFUNCTION(BlueprintCallable, Category = "AI")
 	FVector GetSpawnLocation() const { return SpawnLocation; }
 
+	/** Spawn location at the bottom of the capsule, comparable to navmesh respawn sites */
+	FVector GetSpawnFeetLocation() const;
+
+	/** Pick a random pre-validated navmesh point around the spawn location, false if the pool is still empty */
+	bool GetRandomPooledRoamPoint(FVector& OutLocation) const;
+
+	/** Roam point pool region of the spawn location, INDEX_NONE until registered */
+	int32 GetRoamRegionId() const { return RoamRegionId; }
+
+	/** Park this enemy while the AI subsystem simulates it as a proxy: hidden, net dormant, out of the AI update */
+	void EnterProxy();
+
+	/** Bring a parked enemy back at the proxy's location and take it back into the AI update */
+	void ExitProxy(const FVector& Location, float Yaw);
+
+	/** True while the enemy is parked as a proxy */
+	bool IsProxy() const { return bIsProxy; }
+
+	/** Mark a freshly spawned enemy as pooled so it starts deactivated, call before FinishSpawning */
+	void InitializeForPool();
+
+	/** Hide this enemy and take it out of the AI update, physics and animation so a pool can keep it */
+	void DeactivateForPool();
+
+	/** Bring a pooled enemy back at Location with a new spawn point, cleared cooldowns and fresh AI state */
+	void ActivateFromPool(const FVector& Location, const FRotator& Rotation);
+
+	/** True while the enemy sits deactivated in an enemy pool */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "AI")
+	bool IsInPool() const { return bInPool; }
+
+	/** Server: copy the agent's state into the replicated state, only marked dirty when a quantized value changed */
+	void UpdateReplicatedAIState(EAIState State, const ACharacter* TargetPlayer);
+
+	/** Behavior state, valid on server and clients */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "AI")
+	EAIState GetAIState() const { return ReplicatedAIState.State; }
+
+	/** Chased player, valid on server and clients. Null when not chasing. */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "AI")
+	ACharacter* GetChaseTarget() const;
+
+	/** Called on server and clients when the behavior state changes, for chase/idle presentation */
+	UFUNCTION(BlueprintImplementableEvent, Category = "AI")
+	void OnAIStateChanged(EAIState NewState);
+
 	/** Check if AI can attack (cooldown finished) */
 	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "AI")
 	bool CanAttack() const;
 
 protected:
 	virtual void BeginPlay() override;
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+public:
+	// Clients only, interpolates toward the replicated state
+	virtual void Tick(float DeltaTime) override;
+
+protected:
+	UFUNCTION()
+	void OnRep_ReplicatedAIState(const FRoamingAIReplicatedState& PreviousState);
+
+	// Apply the net update frequency for State
+	void ApplyNetUpdateFrequency(EAIState State);
+
+	// Server: bump the teleport count so clients snap to the new location
+	void MarkTeleported();
+
+	/** State replicated to clients (push model) */
+	UPROPERTY(ReplicatedUsing = OnRep_ReplicatedAIState, BlueprintReadOnly, Category = "AI")
+	FRoamingAIReplicatedState ReplicatedAIState;
+
+	// Client world time the last replicated state arrived
+	double LastReplicatedStateTime;
+
+	// Despawn smoke asset to play, Niagara preferred over Cascade
+	UFXSystemAsset* GetDespawnSmokeEffect() const;
+
+	// Register the roam point pool region for SpawnLocation/MaxRoamDistance
+	void RegisterRoamRegion();
+
+	// Toggle visibility, collision, movement and animation for pooling and proxies
+	void SetPooledActive(bool bActive);
 
 	// Store spawn location for roaming and respawning
 	FVector SpawnLocation;
 
+	// Roam point pool region for SpawnLocation/MaxRoamDistance, INDEX_NONE until registered
+	int32 RoamRegionId;
+
 	// Track last attack time for cooldown
 	float LastAttackTime;
+
+	// Hidden and waiting for CompleteRespawn
+	bool bRespawnPending;
+
+	// Parked while simulated as a proxy
+	bool bIsProxy;
+
+	// Deactivated in an enemy pool
+	bool bInPool;
 };
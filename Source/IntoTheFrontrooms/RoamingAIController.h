@@ -15,62 +15,58 @@ enum class EAIState : uint8
 	Waiting		UMETA(DisplayName = "Waiting")
 };
 
+// Perception events raised by URoamingAISubsystem
+UENUM(BlueprintType)
+enum class ERoamingAIStimulus : uint8
+{
+	EnteredSightRadius	UMETA(DisplayName = "Entered Sight Radius"),	// A player came within SightRange
+	LeftSightRadius		UMETA(DisplayName = "Left Sight Radius"),		// A player moved out of SightRange
+	SightGained			UMETA(DisplayName = "Sight Gained"),			// Line of sight to a player was established
+	SightLost			UMETA(DisplayName = "Sight Lost"),				// No player is visible anymore
+	ChaseLost			UMETA(DisplayName = "Chase Lost")				// Target unseen for LosePlayerTime, back to roaming
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnRoamingAIStimulus, ERoamingAIStimulus, Stimulus, ACharacter*, Player);
+
 /**
- * AI Controller that handles roaming and chase behavior
+ * AI Controller that handles roaming and chase behavior.
+ * Decisions are made in batch by URoamingAISubsystem; the controller only
+ * registers its pawn and executes the movement requests it is given.
  */
 UCLASS()
 class INTOTHEFRONTROOMS_API ARoamingAIController : public AAIController
 {
 	GENERATED_BODY()
 
-public:
-	ARoamingAIController();
-
-protected:
-	virtual void BeginPlay() override;
-	virtual void Tick(float DeltaTime) override;
-	
-	// Called when AI movement completes or fails
-	virtual void OnMoveCompleted(FAIRequestID RequestID, const FPathFollowingResult& Result) override;
+	friend class URoamingAISubsystem;
 
-	// AI Behavior Functions
-	void UpdateAIBehavior();
-	void RoamBehavior();
-	void ChaseBehavior();
-	void WaitBehavior(float DeltaTime);
-
-	// Line of Sight Check
-	bool CanSeePlayer();
+public:
+	ARoamingAIController(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
 
-	// Get random location for roaming
-	FVector GetRandomRoamLocation();
+	/** Add this controller's pawn to the batched AI update, starting from fresh roaming state */
+	void RegisterWithSubsystem();
 
-	// Find the closest player character (multiplayer support)
-	ACharacter* FindClosestPlayer();
+	/** Remove this controller from the batched AI update */
+	void UnregisterFromSubsystem();
 
 protected:
-	// Current AI state
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "AI|State")
-	EAIState CurrentState;
-
-	// Reference to player character
-	UPROPERTY()
-	class ACharacter* PlayerCharacter;
-
-	// Time since last saw player
-	float TimeSinceLastSawPlayer;
-
-	// Timer for waiting at roam destination
-	float WaitTimer;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void OnPossess(APawn* InPawn) override;
+	virtual void OnUnPossess() override;
 
-	// Current roam destination
-	FVector CurrentRoamDestination;
+	// Called when AI movement completes or fails
+	virtual void OnMoveCompleted(FAIRequestID RequestID, const FPathFollowingResult& Result) override;
 
-	// Flag to check if AI reached destination
-	bool bReachedDestination;
+protected:
+	// Slot in the subsystem's agent arrays, INDEX_NONE while unregistered
+	int32 AgentIndex;
 
 public:
 	// Get current AI state
 	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "AI")
-	EAIState GetCurrentState() const { return CurrentState; }
+	EAIState GetCurrentState() const;
+
+	/** Called for every perception event, Player is null when it is no longer known (e.g. ChaseLost) */
+	UPROPERTY(BlueprintAssignable, Category = "AI")
+	FOnRoamingAIStimulus OnStimulus;
 };
@@ -0,0 +1,9 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "RoamingAICrowdController.h"
+#include "Navigation/CrowdFollowingComponent.h"
+
+ARoamingAICrowdController::ARoamingAICrowdController(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer.SetDefaultSubobjectClass<UCrowdFollowingComponent>(TEXT("PathFollowingComponent")))
+{
+}
@@ -0,0 +1,22 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RoamingAIController.h"
+#include "RoamingAICrowdController.generated.h"
+
+/**
+ * Roaming AI controller that follows paths through the Detour crowd manager,
+ * so groups of enemies steer around each other in narrow corridors.
+ * URoamingAISubsystem decides which crowd agents are simulated and at what
+ * avoidance quality; agents beyond its budget use plain path following.
+ */
+UCLASS()
+class INTOTHEFRONTROOMS_API ARoamingAICrowdController : public ARoamingAIController
+{
+	GENERATED_BODY()
+
+public:
+	ARoamingAICrowdController(const FObjectInitializer& ObjectInitializer);
+};
@@ -0,0 +1,1869 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "RoamingAISubsystem.h"
+#include "RoamingAICharacter.h"
+#include "RoamPointPoolSubsystem.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "NavigationSystem.h"
+#include "Navigation/PathFollowingComponent.h"
+#include "Navigation/CrowdFollowingComponent.h"
+#include "Navigation/CrowdManager.h"
+#include "Components/CapsuleComponent.h"
+#include "Engine/World.h"
+#include "ProfilingDebugging/ScopedTimers.h"
+
+DECLARE_STATS_GROUP(TEXT("RoamingAI"), STATGROUP_RoamingAI, STATCAT_Advanced);
+DECLARE_CYCLE_STAT(TEXT("Update"), STAT_RoamingAIUpdate, STATGROUP_RoamingAI);
+DECLARE_CYCLE_STAT(TEXT("Sight"), STAT_RoamingAISight, STATGROUP_RoamingAI);
+DECLARE_CYCLE_STAT(TEXT("Path"), STAT_RoamingAIPath, STATGROUP_RoamingAI);
+DECLARE_CYCLE_STAT(TEXT("Respawn"), STAT_RoamingAIRespawn, STATGROUP_RoamingAI);
+
+int32 FRoamingAIAgentArrays::Add(ARoamingAIController* Controller, ARoamingAICharacter* Character)
+{
+	Controllers.Add(Controller);
+	Characters.Add(Character);
+	Positions.Add(Character->GetActorLocation());
+	States.Add(EAIState::Roaming);
+	WaitTimers.Add(0.0f);
+	SeenPlayers.Add(nullptr);
+	LoseSightSerials.Add(0);
+	TargetPlayers.Add(INDEX_NONE);
+	TargetDistances.Add(MAX_FLT);
+	RoamDestinations.Add(FVector::ZeroVector);
+	ReachedDestination.Add(true); // Start by needing a new destination
+	StuckTimers.Add(0.0f);
+	NextRepathTimes.Add(0.0);
+	LastRepathTimes.Add(0.0);
+	RepathGoals.Add(FVector::ZeroVector);
+	RepathPhases.Add(FMath::FRand());
+	PathQueryIds.Add(0);
+	VisiblePlayers.Add(INDEX_NONE);
+	TickTiers.Add(ERoamingAITickTier::Near);
+	PendingDeltaTimes.Add(0.0f);
+	Respawning.Add(false);
+	FollowingFlowField.Add(false);
+	FlowFieldRetryTimes.Add(0.0);
+	FlowFieldDirections.Add(FVector::ZeroVector);
+	CrowdQualities.Add(INDEX_NONE);
+	return Controllers.Num() - 1;
+}
+
+void FRoamingAIAgentArrays::RemoveAtSwap(int32 Index)
+{
+	Controllers.RemoveAtSwap(Index);
+	Characters.RemoveAtSwap(Index);
+	Positions.RemoveAtSwap(Index);
+	States.RemoveAtSwap(Index);
+	WaitTimers.RemoveAtSwap(Index);
+	SeenPlayers.RemoveAtSwap(Index);
+	LoseSightSerials.RemoveAtSwap(Index);
+	TargetPlayers.RemoveAtSwap(Index);
+	TargetDistances.RemoveAtSwap(Index);
+	RoamDestinations.RemoveAtSwap(Index);
+	ReachedDestination.RemoveAtSwap(Index);
+	StuckTimers.RemoveAtSwap(Index);
+	NextRepathTimes.RemoveAtSwap(Index);
+	LastRepathTimes.RemoveAtSwap(Index);
+	RepathGoals.RemoveAtSwap(Index);
+	RepathPhases.RemoveAtSwap(Index);
+	PathQueryIds.RemoveAtSwap(Index);
+	VisiblePlayers.RemoveAtSwap(Index);
+	TickTiers.RemoveAtSwap(Index);
+	PendingDeltaTimes.RemoveAtSwap(Index);
+	Respawning.RemoveAtSwap(Index);
+	FollowingFlowField.RemoveAtSwap(Index);
+	FlowFieldRetryTimes.RemoveAtSwap(Index);
+	FlowFieldDirections.RemoveAtSwap(Index);
+	CrowdQualities.RemoveAtSwap(Index);
+}
+
+int32 FRoamingAIProxyArrays::Add(ARoamingAICharacter* Character, EAIState State, float WaitTimer)
+{
+	Characters.Add(Character);
+	Positions.Add(Character->GetNavAgentLocation());
+	Yaws.Add(Character->GetActorRotation().Yaw);
+	RoamRegionIds.Add(Character->GetRoamRegionId());
+	States.Add(State);
+	PathPoints.AddDefaulted();
+	NextPathPoints.Add(0);
+	WaitTimers.Add(WaitTimer);
+	RoamingSpeeds.Add(Character->RoamingSpeed);
+	RoamWaitTimes.Add(Character->RoamWaitTime);
+	return Characters.Num() - 1;
+}
+
+void FRoamingAIProxyArrays::RemoveAtSwap(int32 Index)
+{
+	Characters.RemoveAtSwap(Index);
+	Positions.RemoveAtSwap(Index);
+	Yaws.RemoveAtSwap(Index);
+	RoamRegionIds.RemoveAtSwap(Index);
+	States.RemoveAtSwap(Index);
+	PathPoints.RemoveAtSwap(Index);
+	NextPathPoints.RemoveAtSwap(Index);
+	WaitTimers.RemoveAtSwap(Index);
+	RoamingSpeeds.RemoveAtSwap(Index);
+	RoamWaitTimes.RemoveAtSwap(Index);
+}
+
+URoamingAISubsystem::URoamingAISubsystem()
+{
+	// Default LOD settings, overridden from Config/DefaultGame.ini
+	FixedStepHz = 20.0f;
+	MaxStepsPerFrame = 4;
+	NearTierDistance = 3000.0f;
+	MidTierDistance = 8000.0f;
+	MidTierUpdateRate = 5.0f;
+	FarAgentBudget = 8;
+	SpatialGridCellSize = 2000.0f;
+	SightCacheMoveThreshold = 25.0f;
+	SightCacheLifetime = 0.5f;
+	ChaseRepathMinInterval = 0.1f;
+	ChaseRepathMaxInterval = 1.0f;
+	ChaseRepathFarDistance = 3000.0f;
+	RepathGoalMoveThreshold = 75.0f;
+	MaxPathQueriesPerFrame = 8;
+	MaxPathQueriesInFlight = 32;
+	PathQueryTimeout = 5.0f;
+	MaxPathQueryRetries = 1;
+	bUseChaseFlowFields = true;
+	ChaseFlowFieldMinChasers = 2;
+	ChaseFlowFieldRadius = 4000.0f;
+	ChaseFlowFieldCellSize = 200.0f;
+	ChaseFlowFieldMaxStepHeight = 50.0f;
+	ChaseFlowFieldBuildCellsPerFrame = 256;
+	CrowdAgentBudget = 40;
+	CrowdHighQualityAgents = 8;
+	CrowdBudgetUpdateInterval = 0.5f;
+	bUseProxyAgents = true;
+	ProxyDemoteDistance = 15000.0f;
+	ProxyPromoteDistance = 12000.0f;
+	ProxyUpdateRate = 2.0f;
+	MaxProxyTransitionsPerFrame = 2;
+	MaxProxyPathsPerStep = 4;
+	RespawnCandidates = 8;
+	RespawnTracesPerFrame = 16;
+	RespawnMinPlayerDistance = 1000.0f;
+	RespawnViewHalfAngle = 70.0f;
+}
+
+void URoamingAISubsystem::Deinitialize()
+{
+	for (ARoamingAIController* Controller : Agents.Controllers)
+	{
+		if (Controller)
+		{
+			Controller->AgentIndex = INDEX_NONE;
+		}
+	}
+	Agents = FRoamingAIAgentArrays();
+	PlayerCharacters.Reset();
+	PlayerPositions.Reset();
+	PlayerGrid.Reset();
+	AgentGrid.Reset();
+	SightTraces.Reset();
+	SightCache.Reset();
+	SightRadiusPairs.Reset();
+	SightPairs.Reset();
+	ChaseDeadlines.Reset();
+	PathRequests.Reset();
+	RespawnQueries.Reset();
+	Proxies = FRoamingAIProxyArrays();
+	ChaseFields.Reset();
+	PlayerFlowFields.Reset();
+
+	Super::Deinitialize();
+}
+
+bool URoamingAISubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId URoamingAISubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(URoamingAISubsystem, STATGROUP_Tickables);
+}
+
+int32 URoamingAISubsystem::RegisterAgent(ARoamingAIController* Controller, ARoamingAICharacter* Character)
+{
+	if (!Controller || !Character)
+		return INDEX_NONE;
+
+	if (Controller->AgentIndex != INDEX_NONE)
+	{
+		UnregisterAgent(Controller);
+	}
+
+	Controller->AgentIndex = Agents.Add(Controller, Character);
+	return Controller->AgentIndex;
+}
+
+void URoamingAISubsystem::UnregisterAgent(ARoamingAIController* Controller)
+{
+	if (!Controller || !Agents.Controllers.IsValidIndex(Controller->AgentIndex))
+		return;
+
+	const int32 Index = Controller->AgentIndex;
+	Controller->AgentIndex = INDEX_NONE;
+
+	// Keep indices stable while the batch is iterating, the slot is removed afterwards
+	if (bUpdatingAgents)
+	{
+		Agents.Controllers[Index] = nullptr;
+		Agents.Characters[Index] = nullptr;
+		PendingRemovals.Add(Index);
+		return;
+	}
+
+	Agents.RemoveAtSwap(Index);
+	if (Agents.Controllers.IsValidIndex(Index) && Agents.Controllers[Index])
+	{
+		Agents.Controllers[Index]->AgentIndex = Index;
+	}
+}
+
+void URoamingAISubsystem::FlushPendingRemovals()
+{
+	// Remove from the back so swapped-in agents are never pending themselves
+	PendingRemovals.Sort(TGreater<int32>());
+	for (int32 Index : PendingRemovals)
+	{
+		Agents.RemoveAtSwap(Index);
+		if (Agents.Controllers.IsValidIndex(Index) && Agents.Controllers[Index])
+		{
+			Agents.Controllers[Index]->AgentIndex = Index;
+		}
+	}
+	PendingRemovals.Reset();
+}
+
+EAIState URoamingAISubsystem::GetAgentState(int32 AgentIndex) const
+{
+	return Agents.States.IsValidIndex(AgentIndex) ? Agents.States[AgentIndex] : EAIState::Roaming;
+}
+
+void URoamingAISubsystem::Tick(float DeltaTime)
+{
+	UWorld* World = GetWorld();
+	if (!World || !World->HasBegunPlay())
+		return;
+
+	SCOPE_CYCLE_COUNTER(STAT_RoamingAIUpdate);
+	FScopedDurationTimer UpdateTimer(PerfCounters.UpdateSeconds);
+
+	// Async trace results are only readable on the frame after they were issued, so these run every frame
+	ConsumeSightTraces();
+	UpdateRespawnQueries();
+
+	// Decisions run at a fixed rate regardless of frame rate
+	if (FixedStepHz > 0.0f)
+	{
+		const float StepTime = 1.0f / FixedStepHz;
+		StepAccumulator += DeltaTime;
+
+		int32 Steps = 0;
+		while (StepAccumulator >= StepTime && Steps < MaxStepsPerFrame)
+		{
+			SimulateStep(StepTime);
+			StepAccumulator -= StepTime;
+			++Steps;
+		}
+
+		// Drop the backlog after a hitch instead of spiralling
+		StepAccumulator = FMath::Min(StepAccumulator, StepTime);
+	}
+	else
+	{
+		SimulateStep(DeltaTime);
+	}
+
+	// Movement input is consumed every frame, keep flow field chasers moving between steps
+	for (int32 Index = 0; Index < Agents.Num(); ++Index)
+	{
+		if (Agents.FollowingFlowField[Index] && Agents.Characters[Index])
+		{
+			Agents.Characters[Index]->AddMovementInput(Agents.FlowFieldDirections[Index]);
+		}
+	}
+}
+
+void URoamingAISubsystem::SimulateStep(float DeltaTime)
+{
+	UWorld* World = GetWorld();
+
+	GatherPlayers();
+	PathQueriesStartedThisFrame = 0;
+	++PerfCounters.Steps;
+
+	// Before positions and grids are refreshed, demotions remove agents from the arrays
+	UpdateProxies(DeltaTime);
+
+	// Refresh cached positions in one pass
+	MaxAgentSightRange = 0.0f;
+	for (int32 Index = 0; Index < Agents.Num(); ++Index)
+	{
+		if (ARoamingAICharacter* AIChar = Agents.Characters[Index])
+		{
+			Agents.Positions[Index] = AIChar->GetActorLocation();
+			MaxAgentSightRange = FMath::Max(MaxAgentSightRange, AIChar->SightRange);
+		}
+	}
+
+	RebuildSpatialGrids();
+
+	if (Agents.Num() == 0)
+		return;
+
+	// Perception events may destroy actors, keep indices stable from here on
+	bUpdatingAgents = true;
+
+	UpdateSight();
+	ProcessChaseDeadlines(World->GetTimeSeconds());
+	ExpirePathQueries(World->GetTimeSeconds());
+
+	// Accumulate elapsed step time and pick each agent's tier for this step
+	PlayerChaserCounts.Init(0, PlayerCharacters.Num());
+	for (int32 Index = 0; Index < Agents.Num(); ++Index)
+	{
+		Agents.PendingDeltaTimes[Index] += DeltaTime;
+
+		// Find closest player (multiplayer support)
+		float DistanceToPlayer = MAX_FLT;
+		const int32 ClosestIndex = FindClosestPlayer(Index, DistanceToPlayer);
+		Agents.TickTiers[Index] = ClassifyTier(Index, DistanceToPlayer);
+
+		// A visible player takes priority over the closest one
+		const int32 VisibleIndex = Agents.VisiblePlayers[Index];
+		if (VisibleIndex != INDEX_NONE && VisibleIndex != ClosestIndex)
+		{
+			Agents.TargetPlayers[Index] = VisibleIndex;
+			Agents.TargetDistances[Index] = FVector::Dist(Agents.Positions[Index], PlayerPositions[VisibleIndex]);
+		}
+		else
+		{
+			Agents.TargetPlayers[Index] = ClosestIndex;
+			Agents.TargetDistances[Index] = DistanceToPlayer;
+		}
+
+		if (Agents.States[Index] == EAIState::Chasing && Agents.TargetPlayers[Index] != INDEX_NONE)
+		{
+			++PlayerChaserCounts[Agents.TargetPlayers[Index]];
+		}
+	}
+
+	UpdateChaseFlowFields();
+	UpdateCrowdBudget();
+
+	const float MidTierInterval = MidTierUpdateRate > 0.0f ? 1.0f / MidTierUpdateRate : 0.0f;
+
+	for (int32 Index = 0; Index < Agents.Num(); ++Index)
+	{
+		switch (Agents.TickTiers[Index])
+		{
+			case ERoamingAITickTier::Near:
+				UpdateAgent(Index);
+				break;
+
+			case ERoamingAITickTier::Mid:
+				if (Agents.PendingDeltaTimes[Index] >= MidTierInterval)
+				{
+					UpdateAgent(Index);
+				}
+				break;
+
+			case ERoamingAITickTier::Far:
+				break;
+		}
+	}
+	UpdateFarAgents();
+
+	// Mirror state onto the pawns for clients, only changed values dirty the replicated property
+	for (int32 Index = 0; Index < Agents.Num(); ++Index)
+	{
+		ARoamingAICharacter* AIChar = Agents.Characters[Index];
+		if (!AIChar || Agents.Respawning[Index])
+			continue;
+
+		const int32 TargetIndex = Agents.TargetPlayers[Index];
+		const bool bHasTarget = Agents.States[Index] == EAIState::Chasing && PlayerCharacters.IsValidIndex(TargetIndex);
+		AIChar->UpdateReplicatedAIState(Agents.States[Index], bHasTarget ? PlayerCharacters[TargetIndex].Get() : nullptr);
+	}
+	bUpdatingAgents = false;
+
+	FlushPendingRemovals();
+}
+
+void URoamingAISubsystem::RebuildSpatialGrids()
+{
+	PlayerGrid.SetCellSize(SpatialGridCellSize);
+	PlayerGrid.Reset();
+	for (int32 PlayerIndex = 0; PlayerIndex < PlayerPositions.Num(); ++PlayerIndex)
+	{
+		PlayerGrid.Add(PlayerIndex, PlayerPositions[PlayerIndex]);
+	}
+	PlayerGrid.Build();
+
+	AgentGrid.SetCellSize(SpatialGridCellSize);
+	AgentGrid.Reset();
+	for (int32 Index = 0; Index < Agents.Num(); ++Index)
+	{
+		if (Agents.Characters[Index])
+		{
+			AgentGrid.Add(Index, Agents.Positions[Index]);
+		}
+	}
+	AgentGrid.Build();
+}
+
+void URoamingAISubsystem::QueryPlayersInRadius(const FVector& Location, float Radius, TArray<ACharacter*>& OutPlayers) const
+{
+	OutPlayers.Reset();
+	QueryScratch.Reset();
+	PlayerGrid.QueryRadius(Location, Radius, QueryScratch);
+	for (int32 PlayerIndex : QueryScratch)
+	{
+		OutPlayers.Add(PlayerCharacters[PlayerIndex]);
+	}
+}
+
+void URoamingAISubsystem::QueryNearestPlayers(const FVector& Location, int32 Count, TArray<ACharacter*>& OutPlayers) const
+{
+	OutPlayers.Reset();
+	PlayerGrid.QueryNearest(Location, Count, QueryScratch);
+	for (int32 PlayerIndex : QueryScratch)
+	{
+		OutPlayers.Add(PlayerCharacters[PlayerIndex]);
+	}
+}
+
+void URoamingAISubsystem::QueryPlayersInSightRange(const ARoamingAICharacter* Agent, TArray<ACharacter*>& OutPlayers) const
+{
+	OutPlayers.Reset();
+	if (Agent)
+	{
+		QueryPlayersInRadius(Agent->GetActorLocation(), Agent->SightRange, OutPlayers);
+	}
+}
+
+void URoamingAISubsystem::QueryAgentsInRadius(const FVector& Location, float Radius, TArray<ARoamingAICharacter*>& OutAgents) const
+{
+	OutAgents.Reset();
+	QueryScratch.Reset();
+	AgentGrid.QueryRadius(Location, Radius, QueryScratch);
+	for (int32 Index : QueryScratch)
+	{
+		if (Agents.Characters.IsValidIndex(Index) && Agents.Characters[Index])
+		{
+			OutAgents.Add(Agents.Characters[Index]);
+		}
+	}
+}
+
+void URoamingAISubsystem::ConsumeSightTraces()
+{
+	SCOPE_CYCLE_COUNTER(STAT_RoamingAISight);
+	FScopedDurationTimer SightTimer(PerfCounters.SightSeconds);
+
+	UWorld* World = GetWorld();
+	const double Now = World->GetTimeSeconds();
+
+	for (const FRoamingAISightTrace& Trace : SightTraces)
+	{
+		FRoamingAISightCacheEntry* Entry = SightCache.Find(Trace.CacheKey);
+		if (!Entry)
+			continue;
+
+		Entry->bTracePending = false;
+
+		FTraceDatum TraceData;
+		if (!World->QueryTraceData(Trace.Handle, TraceData))
+			continue; // Result lost, the pair is traced again on its next lookup
+
+		// If nothing blocks the trace, we can see the player
+		Entry->bVisible = FHitResult::GetFirstBlockingHit(TraceData.OutHits) == nullptr;
+		Entry->bHasResult = true;
+		Entry->ResultTime = Now;
+	}
+
+	SightTraces.Reset();
+}
+
+void URoamingAISubsystem::UpdateSight()
+{
+	SCOPE_CYCLE_COUNTER(STAT_RoamingAISight);
+	FScopedDurationTimer SightTimer(PerfCounters.SightSeconds);
+
+	UWorld* World = GetWorld();
+	const double Now = World->GetTimeSeconds();
+	const float MoveThresholdSq = FMath::Square(SightCacheMoveThreshold);
+
+	FrameSightStats = FRoamingAISightStats();
+
+	UpdateSightRadiusPairs();
+
+	for (int32& VisiblePlayer : Agents.VisiblePlayers)
+	{
+		VisiblePlayer = INDEX_NONE;
+	}
+
+	// Only agents with a player inside their sight radius are looked at
+	int32 PairIndex = 0;
+	while (PairIndex < SightPairs.Num())
+	{
+		const int32 Index = SightPairs[PairIndex].X;
+		const int32 FirstPair = PairIndex;
+		while (PairIndex < SightPairs.Num() && SightPairs[PairIndex].X == Index)
+		{
+			++PairIndex;
+		}
+
+		ARoamingAIController* Controller = Agents.Controllers[Index];
+		ARoamingAICharacter* AIChar = Agents.Characters[Index];
+		if (!Controller || !AIChar)
+			continue;
+
+		const FVector& AILocation = Agents.Positions[Index];
+
+		// Get proper eye height using capsule component
+		float EyeHeight = 90.0f; // Fallback
+		if (UCapsuleComponent* CapsuleComp = AIChar->GetCapsuleComponent())
+		{
+			EyeHeight = CapsuleComp->GetScaledCapsuleHalfHeight() * 0.9f; // 90% of capsule height
+		}
+		const FVector AgentEye = AILocation + FVector(0.0f, 0.0f, EyeHeight);
+
+		// Chasers keep tracking their target all around them
+		const bool bUseViewCone = Agents.States[Index] != EAIState::Chasing && AIChar->SightHalfAngle < 180.0f;
+		const float ViewConeCos = FMath::Cos(FMath::DegreesToRadians(AIChar->SightHalfAngle));
+		const FVector Forward = AIChar->GetActorForwardVector();
+
+		float ClosestVisibleDistSq = MAX_FLT;
+
+		for (int32 AgentPair = FirstPair; AgentPair < PairIndex; ++AgentPair)
+		{
+			const int32 PlayerIndex = SightPairs[AgentPair].Y;
+			ACharacter* Player = PlayerCharacters[PlayerIndex];
+			const FVector PlayerEye = PlayerPositions[PlayerIndex] + FVector(0.0f, 0.0f, EyeHeight);
+			const FVector ToPlayer = PlayerEye - AgentEye;
+
+			// Cheap gates before touching the cache or issuing a trace
+			if (FMath::Abs(ToPlayer.Z) > AIChar->MaxSightHeightDifference ||
+				(bUseViewCone && FVector::DotProduct(Forward, ToPlayer.GetSafeNormal()) < ViewConeCos))
+			{
+				++FrameSightStats.GateRejections;
+				continue;
+			}
+
+			const uint64 CacheKey = MakeSightCacheKey(Controller, Player);
+			FRoamingAISightCacheEntry& Entry = SightCache.FindOrAdd(CacheKey);
+			Entry.LastUsedTime = Now;
+
+			const bool bFresh = Entry.bHasResult &&
+				Now - Entry.ResultTime < SightCacheLifetime &&
+				FVector::DistSquared(Entry.AgentEye, AgentEye) <= MoveThresholdSq &&
+				FVector::DistSquared(Entry.PlayerEye, PlayerEye) <= MoveThresholdSq;
+
+			if (bFresh || Entry.bTracePending)
+			{
+				// Pending pairs keep using their previous result until the new one lands
+				++FrameSightStats.CacheHits;
+			}
+			else
+			{
+				++FrameSightStats.CacheMisses;
+				++FrameSightStats.TracesIssued;
+
+				FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(RoamingAISight), false); // Use simple collision for performance
+				QueryParams.AddIgnoredActor(AIChar);
+				QueryParams.AddIgnoredActor(Player);
+
+				FRoamingAISightTrace& Trace = SightTraces.AddDefaulted_GetRef();
+				Trace.CacheKey = CacheKey;
+				Trace.Handle = World->AsyncLineTraceByChannel(
+					EAsyncTraceType::Single,
+					AgentEye,
+					PlayerEye,
+					ECC_Visibility,
+					QueryParams
+				);
+
+				Entry.AgentEye = AgentEye;
+				Entry.PlayerEye = PlayerEye;
+				Entry.bTracePending = true;
+			}
+
+			// Keep the closest visible player, a result is at most one frame old
+			if (Entry.bHasResult && Entry.bVisible && ToPlayer.SizeSquared() < ClosestVisibleDistSq)
+			{
+				ClosestVisibleDistSq = ToPlayer.SizeSquared();
+				Agents.VisiblePlayers[Index] = PlayerIndex;
+			}
+		}
+	}
+
+	FrameSightStats.TracesSaved = FrameSightStats.CacheHits + FrameSightStats.GateRejections;
+	TotalSightStats.Accumulate(FrameSightStats);
+
+	EvictSightCache(Now);
+
+	// Raise sight events where the seen player changed since last frame
+	for (int32 Index = 0; Index < Agents.Num(); ++Index)
+	{
+		if (!Agents.Controllers[Index])
+			continue;
+
+		const int32 VisibleIndex = Agents.VisiblePlayers[Index];
+		ACharacter* Seen = VisibleIndex != INDEX_NONE ? PlayerCharacters[VisibleIndex].Get() : nullptr;
+		ACharacter* PreviouslySeen = Agents.SeenPlayers[Index].Get();
+		const bool bHadSight = !Agents.SeenPlayers[Index].IsExplicitlyNull();
+
+		if ((Seen && Seen == PreviouslySeen) || (!Seen && !bHadSight))
+			continue;
+
+		Agents.SeenPlayers[Index] = Seen;
+		if (Seen)
+		{
+			RaiseStimulus(Index, ERoamingAIStimulus::SightGained, Seen);
+		}
+		else
+		{
+			RaiseStimulus(Index, ERoamingAIStimulus::SightLost, PreviouslySeen);
+		}
+	}
+}
+
+void URoamingAISubsystem::UpdateSightRadiusPairs()
+{
+	++PerceptionFrame;
+	SightPairs.Reset();
+
+	// Query from each player's side, agents with nobody around cost nothing here
+	for (int32 PlayerIndex = 0; PlayerIndex < PlayerCharacters.Num(); ++PlayerIndex)
+	{
+		ACharacter* Player = PlayerCharacters[PlayerIndex];
+		const FVector& PlayerLocation = PlayerPositions[PlayerIndex];
+
+		QueryScratch.Reset();
+		AgentGrid.QueryRadius(PlayerLocation, MaxAgentSightRange, QueryScratch);
+		for (int32 Index : QueryScratch)
+		{
+			ARoamingAIController* Controller = Agents.Controllers[Index];
+			ARoamingAICharacter* AIChar = Agents.Characters[Index];
+			if (!Controller || !AIChar || Agents.Respawning[Index] ||
+				FVector::DistSquared(Agents.Positions[Index], PlayerLocation) > FMath::Square(AIChar->SightRange))
+				continue;
+
+			SightPairs.Add(FIntPoint(Index, PlayerIndex));
+
+			FRoamingAISightRadiusPair& Pair = SightRadiusPairs.FindOrAdd(MakeSightCacheKey(Controller, Player));
+			const bool bEntered = Pair.LastFrame == 0;
+			Pair.LastFrame = PerceptionFrame;
+			if (bEntered)
+			{
+				Pair.Controller = Controller;
+				Pair.Player = Player;
+				RaiseStimulus(Index, ERoamingAIStimulus::EnteredSightRadius, Player);
+			}
+		}
+	}
+
+	// Pairs not found this frame have left the radius
+	for (auto It = SightRadiusPairs.CreateIterator(); It; ++It)
+	{
+		if (It.Value().LastFrame == PerceptionFrame)
+			continue;
+
+		const FRoamingAISightRadiusPair Pair = It.Value();
+		It.RemoveCurrent();
+
+		ARoamingAIController* Controller = Pair.Controller.Get();
+		if (Controller && Agents.Controllers.IsValidIndex(Controller->AgentIndex))
+		{
+			RaiseStimulus(Controller->AgentIndex, ERoamingAIStimulus::LeftSightRadius, Pair.Player.Get());
+		}
+	}
+
+	SightPairs.Sort([](const FIntPoint& A, const FIntPoint& B) { return A.X < B.X; });
+}
+
+void URoamingAISubsystem::RaiseStimulus(int32 Index, ERoamingAIStimulus Stimulus, ACharacter* Player)
+{
+	ARoamingAIController* Controller = Agents.Controllers[Index];
+	if (!Controller)
+		return;
+
+	switch (Stimulus)
+	{
+		case ERoamingAIStimulus::SightGained:
+			// Spotted a player, chase straight away (also cancels a pending chase-lost deadline)
+			if (Agents.States[Index] != EAIState::Chasing && !Agents.Respawning[Index])
+			{
+				StartChase(Index);
+			}
+			else
+			{
+				++Agents.LoseSightSerials[Index];
+			}
+			break;
+
+		case ERoamingAIStimulus::SightLost:
+			// Give up the chase if sight is not regained within LosePlayerTime
+			if (Agents.States[Index] == EAIState::Chasing)
+			{
+				FRoamingAIChaseDeadline Deadline;
+				Deadline.Time = GetWorld()->GetTimeSeconds() + Agents.Characters[Index]->LosePlayerTime;
+				Deadline.Controller = Controller;
+				Deadline.Serial = ++Agents.LoseSightSerials[Index];
+				ChaseDeadlines.HeapPush(Deadline);
+			}
+			break;
+
+		default:
+			break;
+	}
+
+	Controller->OnStimulus.Broadcast(Stimulus, Player);
+}
+
+void URoamingAISubsystem::ProcessChaseDeadlines(double Now)
+{
+	while (ChaseDeadlines.Num() > 0 && ChaseDeadlines.HeapTop().Time <= Now)
+	{
+		FRoamingAIChaseDeadline Deadline;
+		ChaseDeadlines.HeapPop(Deadline, EAllowShrinking::No);
+
+		ARoamingAIController* Controller = Deadline.Controller.Get();
+		if (!Controller || !Agents.Controllers.IsValidIndex(Controller->AgentIndex))
+			continue;
+
+		// Cancelled by regaining sight, a new chase or a reset since it was scheduled
+		const int32 Index = Controller->AgentIndex;
+		if (Agents.LoseSightSerials[Index] != Deadline.Serial || Agents.States[Index] != EAIState::Chasing)
+			continue;
+
+		// Haven't seen player for specified time, go back to roaming
+		ResetToRoaming(Index);
+		Controller->StopMovement();
+		RaiseStimulus(Index, ERoamingAIStimulus::ChaseLost, nullptr);
+	}
+}
+
+void URoamingAISubsystem::EvictSightCache(double Now)
+{
+	// Pairs drop out of the cache a while after they leave sight range or unregister
+	const double EvictAfter = FMath::Max(SightCacheLifetime * 4.0f, 1.0f);
+	for (auto It = SightCache.CreateIterator(); It; ++It)
+	{
+		if (!It.Value().bTracePending && Now - It.Value().LastUsedTime > EvictAfter)
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void URoamingAISubsystem::RequestRespawn(ARoamingAICharacter* Character)
+{
+	if (!Character)
+		return;
+
+	for (const FRoamingAIRespawnQuery& Query : RespawnQueries)
+	{
+		if (Query.Character == Character)
+			return; // Already searching
+	}
+
+	FRoamingAIRespawnQuery& Query = RespawnQueries.AddDefaulted_GetRef();
+	Query.Character = Character;
+	++PerfCounters.RespawnQueries;
+
+	if (ARoamingAIController* Controller = Cast<ARoamingAIController>(Character->GetController()))
+	{
+		if (Agents.Respawning.IsValidIndex(Controller->AgentIndex))
+		{
+			Agents.Respawning[Controller->AgentIndex] = true;
+			Agents.PathQueryIds[Controller->AgentIndex] = 0; // Drop any path still in flight
+		}
+	}
+}
+
+void URoamingAISubsystem::UpdateRespawnQueries()
+{
+	if (RespawnQueries.Num() == 0)
+		return;
+
+	SCOPE_CYCLE_COUNTER(STAT_RoamingAIRespawn);
+	FScopedDurationTimer RespawnTimer(PerfCounters.RespawnSeconds);
+
+	UWorld* World = GetWorld();
+	int32 TraceBudget = RespawnTracesPerFrame;
+
+	for (int32 QueryIndex = RespawnQueries.Num() - 1; QueryIndex >= 0; --QueryIndex)
+	{
+		FRoamingAIRespawnQuery& Query = RespawnQueries[QueryIndex];
+		if (!Query.Character.IsValid() || !Query.Character->IsRespawning())
+		{
+			// Destroyed, or returned to an enemy pool while hidden
+			RespawnQueries.RemoveAtSwap(QueryIndex);
+			continue;
+		}
+
+		// First step: score candidates, the traces go out from the next step on
+		if (!Query.bCandidatesGathered)
+		{
+			Query.bCandidatesGathered = true;
+			if (!GatherRespawnCandidates(Query))
+			{
+				CompleteRespawnQuery(Query);
+				RespawnQueries.RemoveAtSwap(QueryIndex);
+			}
+			continue;
+		}
+
+		// Read back the traces issued on earlier frames, a clear line means a player could see the site
+		for (; Query.ConsumedTraces < Query.NextTrace; ++Query.ConsumedTraces)
+		{
+			const FRoamingAIRespawnTrace& Trace = Query.Traces[Query.ConsumedTraces];
+			if (!Trace.Handle.IsValid())
+				continue; // Skipped, its candidate was already rejected
+
+			FTraceDatum TraceData;
+			const bool bHasResult = World->QueryTraceData(Trace.Handle, TraceData);
+			if (!bHasResult || FHitResult::GetFirstBlockingHit(TraceData.OutHits) == nullptr)
+			{
+				Query.Scores[Trace.Candidate] = -1.0f; // Lost results count as visible
+			}
+		}
+
+		// Issue the next traces within this frame's budget
+		while (Query.NextTrace < Query.Traces.Num() && TraceBudget > 0)
+		{
+			FRoamingAIRespawnTrace& Trace = Query.Traces[Query.NextTrace++];
+			if (Query.Scores[Trace.Candidate] < 0.0f)
+				continue;
+
+			FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(RoamingAIRespawn), false);
+			QueryParams.AddIgnoredActor(Query.Character.Get());
+			Trace.Handle = World->AsyncLineTraceByChannel(EAsyncTraceType::Single, Trace.Start, Trace.End, ECC_Visibility, QueryParams);
+			--TraceBudget;
+		}
+
+		// Done once every trace has been issued and read back
+		if (Query.ConsumedTraces == Query.Traces.Num())
+		{
+			CompleteRespawnQuery(Query);
+			RespawnQueries.RemoveAtSwap(QueryIndex);
+		}
+	}
+}
+
+bool URoamingAISubsystem::GatherRespawnCandidates(FRoamingAIRespawnQuery& Query)
+{
+	ARoamingAICharacter* Character = Query.Character.Get();
+
+	for (int32 Attempt = 0; Attempt < RespawnCandidates; ++Attempt)
+	{
+		FVector Candidate;
+		if (!Character->GetRandomPooledRoamPoint(Candidate))
+			break;
+		Query.Candidates.AddUnique(Candidate);
+	}
+
+	if (Query.Candidates.Num() == 0)
+		return false;
+
+	// Check the top of the capsule, the part a player would notice first
+	float CheckHeight = 180.0f; // Fallback
+	if (UCapsuleComponent* CapsuleComp = Character->GetCapsuleComponent())
+	{
+		CheckHeight = CapsuleComp->GetScaledCapsuleHalfHeight() * 1.8f;
+	}
+
+	const float ViewConeCos = FMath::Cos(FMath::DegreesToRadians(RespawnViewHalfAngle));
+	const float MinDistanceSq = FMath::Square(RespawnMinPlayerDistance);
+
+	Query.Scores.SetNumUninitialized(Query.Candidates.Num());
+	for (int32 Candidate = 0; Candidate < Query.Candidates.Num(); ++Candidate)
+	{
+		const FVector& Site = Query.Candidates[Candidate];
+
+		float NearestDistance = MAX_FLT;
+		PlayerGrid.FindNearest(Site, MAX_FLT, &NearestDistance);
+		Query.Scores[Candidate] = NearestDistance;
+		if (NearestDistance < RespawnMinPlayerDistance)
+		{
+			Query.Scores[Candidate] = -1.0f;
+			continue;
+		}
+
+		// Only players looking roughly toward the site need a trace
+		const FVector CheckPoint = Site + FVector(0.0f, 0.0f, CheckHeight);
+		for (ACharacter* Player : PlayerCharacters)
+		{
+			if (!IsValid(Player))
+				continue; // Player list is from the last AI step
+
+			const FVector PlayerEye = Player->GetPawnViewLocation();
+			const FVector ToSite = CheckPoint - PlayerEye;
+			if (ToSite.SizeSquared() < MinDistanceSq ||
+				FVector::DotProduct(Player->GetBaseAimRotation().Vector(), ToSite.GetSafeNormal()) < ViewConeCos)
+				continue;
+
+			FRoamingAIRespawnTrace& Trace = Query.Traces.AddDefaulted_GetRef();
+			Trace.Candidate = Candidate;
+			Trace.Start = PlayerEye;
+			Trace.End = CheckPoint;
+		}
+	}
+	return true;
+}
+
+void URoamingAISubsystem::CompleteRespawnQuery(FRoamingAIRespawnQuery& Query)
+{
+	ARoamingAICharacter* Character = Query.Character.Get();
+
+	// Prefer the hidden site farthest from every player
+	int32 BestCandidate = INDEX_NONE;
+	float BestScore = -1.0f;
+	for (int32 Candidate = 0; Candidate < Query.Candidates.Num(); ++Candidate)
+	{
+		if (Query.Scores[Candidate] > BestScore)
+		{
+			BestScore = Query.Scores[Candidate];
+			BestCandidate = Candidate;
+		}
+	}
+
+	FVector RespawnLocation;
+	if (BestCandidate != INDEX_NONE)
+	{
+		RespawnLocation = Query.Candidates[BestCandidate];
+	}
+	else if (!Character->FindRandomRespawnLocation(RespawnLocation))
+	{
+		// Every site was in view or the pool is still empty, fall back to the spawn point
+		RespawnLocation = Character->GetSpawnFeetLocation();
+	}
+
+	Character->CompleteRespawn(RespawnLocation);
+
+	if (ARoamingAIController* Controller = Cast<ARoamingAIController>(Character->GetController()))
+	{
+		const int32 Index = Controller->AgentIndex;
+		if (Agents.Respawning.IsValidIndex(Index))
+		{
+			Agents.Respawning[Index] = false;
+			Agents.Positions[Index] = Character->GetActorLocation();
+			ResetToRoaming(Index);
+		}
+	}
+}
+
+void URoamingAISubsystem::UpdateChaseFlowFields()
+{
+	PlayerFlowFields.Init(nullptr, PlayerCharacters.Num());
+	if (!bUseChaseFlowFields)
+	{
+		ChaseFields.Reset();
+		return;
+	}
+
+	UNavigationSystemV1* NavSystem = UNavigationSystemV1::GetCurrent(GetWorld());
+	const ANavigationData* NavData = NavSystem ? NavSystem->GetDefaultNavDataInstance(FNavigationSystem::DontCreate) : nullptr;
+	if (!NavData)
+		return;
+
+	const double Now = GetWorld()->GetTimeSeconds();
+	int32 CellBudget = ChaseFlowFieldBuildCellsPerFrame;
+
+	for (int32 PlayerIndex = 0; PlayerIndex < PlayerCharacters.Num(); ++PlayerIndex)
+	{
+		if (PlayerChaserCounts[PlayerIndex] < ChaseFlowFieldMinChasers)
+			continue;
+
+		FRoamingAIChaseFieldState& FieldState = ChaseFields.FindOrAdd(PlayerCharacters[PlayerIndex]);
+		FieldState.LastUsedTime = Now;
+
+		const FVector& PlayerLocation = PlayerPositions[PlayerIndex];
+		FChaseFlowField* Active = &FieldState.Fields[FieldState.ActiveField];
+		FChaseFlowField* Pending = &FieldState.Fields[1 - FieldState.ActiveField];
+
+		// Build the next field once the player heads out of the middle of the current one
+		const bool bActiveCovers = Active->IsBuilt() &&
+			FVector::Dist2D(PlayerLocation, Active->GetCenter()) < Active->GetRadius() * 0.5f;
+		if (!bActiveCovers && !Pending->IsBuilding())
+		{
+			Pending->BeginBuild(PlayerLocation, ChaseFlowFieldRadius, ChaseFlowFieldCellSize, ChaseFlowFieldMaxStepHeight, 250.0f);
+		}
+
+		if (Pending->IsBuilding() && CellBudget > 0 && Pending->ContinueBuild(*NavData, CellBudget))
+		{
+			// Swap in the new field, it still needs its first integration below
+			FieldState.ActiveField = 1 - FieldState.ActiveField;
+			Active->Reset();
+			Active = Pending;
+		}
+
+		// Distances only change when the player crosses into another cell
+		if (Active->IsBuilt() && Active->GetCellIndex(PlayerLocation) != Active->GetGoalCell())
+		{
+			Active->Integrate(PlayerLocation);
+		}
+	}
+
+	// Drop fields of players nobody has chased for a while
+	for (auto It = ChaseFields.CreateIterator(); It; ++It)
+	{
+		if (!It.Key().ResolveObjectPtr() || Now - It.Value().LastUsedTime > 5.0)
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	// Map is not modified again this frame, so these pointers stay valid for the agent updates
+	for (int32 PlayerIndex = 0; PlayerIndex < PlayerCharacters.Num(); ++PlayerIndex)
+	{
+		if (PlayerChaserCounts[PlayerIndex] < ChaseFlowFieldMinChasers)
+			continue;
+
+		if (const FRoamingAIChaseFieldState* FieldState = ChaseFields.Find(PlayerCharacters[PlayerIndex]))
+		{
+			const FChaseFlowField& Field = FieldState->Fields[FieldState->ActiveField];
+			if (Field.IsBuilt() && Field.GetGoalCell() != INDEX_NONE)
+			{
+				PlayerFlowFields[PlayerIndex] = &Field;
+			}
+		}
+	}
+}
+
+bool URoamingAISubsystem::FollowChaseFlowField(int32 Index, double Now)
+{
+	const int32 TargetIndex = Agents.TargetPlayers[Index];
+	const FChaseFlowField* Field = PlayerFlowFields[TargetIndex];
+	const FVector& Location = Agents.Positions[Index];
+
+	FVector Direction = FVector::ZeroVector;
+	bool bOnField = Field && Now >= Agents.FlowFieldRetryTimes[Index];
+	if (bOnField)
+	{
+		if (Field->GetCellIndex(Location) == Field->GetGoalCell())
+		{
+			// Same cell as the player, close the last gap directly
+			const FVector ToTarget = PlayerPositions[TargetIndex] - Location;
+			Direction = FVector(ToTarget.X, ToTarget.Y, 0.0f).GetSafeNormal();
+			bOnField = !Direction.IsNearlyZero();
+		}
+		else
+		{
+			bOnField = Field->GetMoveDirection(Location, Direction);
+		}
+	}
+
+	if (!bOnField)
+	{
+		if (Agents.FollowingFlowField[Index])
+		{
+			// Left the field, path on this update instead of waiting for the next slot
+			Agents.FollowingFlowField[Index] = false;
+			Agents.NextRepathTimes[Index] = 0.0;
+		}
+		return false;
+	}
+
+	if (!Agents.FollowingFlowField[Index])
+	{
+		// Hand over from path following, the field steers the pawn directly from now on
+		Agents.FollowingFlowField[Index] = true;
+		Agents.PathQueryIds[Index] = 0;
+		Agents.Controllers[Index]->StopMovement();
+	}
+
+	// Applied as movement input every frame by Tick
+	Agents.FlowFieldDirections[Index] = Direction;
+	return true;
+}
+
+void URoamingAISubsystem::UpdateCrowdBudget()
+{
+	const double Now = GetWorld()->GetTimeSeconds();
+	if (Now < NextCrowdBudgetTime)
+		return;
+	NextCrowdBudgetTime = Now + CrowdBudgetUpdateInterval;
+
+	// Crowd-following agents, nearest to their target first
+	TArray<TPair<float, int32>, TInlineAllocator<64>> CrowdAgents;
+	for (int32 Index = 0; Index < Agents.Num(); ++Index)
+	{
+		ARoamingAIController* Controller = Agents.Controllers[Index];
+		if (Controller && Cast<UCrowdFollowingComponent>(Controller->GetPathFollowingComponent()))
+		{
+			CrowdAgents.Add(TPair<float, int32>(Agents.TargetDistances[Index], Index));
+		}
+	}
+	if (CrowdAgents.Num() == 0)
+		return;
+
+	CrowdAgents.Sort([](const TPair<float, int32>& A, const TPair<float, int32>& B) { return A.Key < B.Key; });
+
+	for (int32 Rank = 0; Rank < CrowdAgents.Num(); ++Rank)
+	{
+		const int32 Index = CrowdAgents[Rank].Value;
+		UCrowdFollowingComponent* CrowdComp = Cast<UCrowdFollowingComponent>(Agents.Controllers[Index]->GetPathFollowingComponent());
+
+		// Agents beyond the budget leave the crowd and fall back to plain path following.
+		// The state only changes while the agent is not following a path, otherwise it is retried on the next pass.
+		const bool bSimulate = Rank < CrowdAgentBudget && !Agents.Respawning[Index];
+		if (CrowdComp->IsCrowdSimulationEnabled() != bSimulate)
+		{
+			CrowdComp->SetCrowdSimulationState(bSimulate ? ECrowdSimulationState::Enabled : ECrowdSimulationState::Disabled);
+		}
+
+		if (!CrowdComp->IsCrowdSimulationEnabled())
+		{
+			Agents.CrowdQualities[Index] = INDEX_NONE;
+			continue;
+		}
+
+		const int8 Quality = Rank < CrowdHighQualityAgents ? ECrowdAvoidanceQuality::High : ECrowdAvoidanceQuality::Medium;
+		if (Agents.CrowdQualities[Index] != Quality)
+		{
+			CrowdComp->SetCrowdAvoidanceQuality(ECrowdAvoidanceQuality::Type(Quality));
+			Agents.CrowdQualities[Index] = Quality;
+		}
+	}
+}
+
+float URoamingAISubsystem::GetNearestPlayerDistSquared(const FVector& Location) const
+{
+	float NearestDistSq = MAX_FLT;
+	for (const FVector& PlayerLocation : PlayerPositions)
+	{
+		NearestDistSq = FMath::Min(NearestDistSq, FVector::DistSquared(Location, PlayerLocation));
+	}
+	return NearestDistSq;
+}
+
+void URoamingAISubsystem::UpdateProxies(float DeltaTime)
+{
+	if (!bUseProxyAgents)
+	{
+		// Bring every proxy back if the feature was switched off at runtime
+		for (int32 ProxyIndex = Proxies.Num() - 1; ProxyIndex >= 0; --ProxyIndex)
+		{
+			PromoteProxy(ProxyIndex);
+		}
+		return;
+	}
+
+	// Demote far roaming agents, using last frame's tiers and distances
+	TArray<ARoamingAICharacter*, TInlineAllocator<8>> ToDemote;
+	for (int32 Index = 0; Index < Agents.Num() && ToDemote.Num() < MaxProxyTransitionsPerFrame; ++Index)
+	{
+		ARoamingAICharacter* AIChar = Agents.Characters[Index];
+		if (AIChar && AIChar->bAllowProxyRepresentation &&
+			Agents.TickTiers[Index] == ERoamingAITickTier::Far &&
+			Agents.States[Index] != EAIState::Chasing && !Agents.Respawning[Index] &&
+			GetNearestPlayerDistSquared(AIChar->GetActorLocation()) > FMath::Square(ProxyDemoteDistance))
+		{
+			ToDemote.Add(AIChar);
+		}
+	}
+	for (ARoamingAICharacter* AIChar : ToDemote)
+	{
+		DemoteAgent(AIChar);
+	}
+
+	// Proxies are cheap but still only need a coarse step rate
+	ProxyPendingTime += DeltaTime;
+	const float ProxyInterval = ProxyUpdateRate > 0.0f ? 1.0f / ProxyUpdateRate : 0.0f;
+	if (ProxyPendingTime >= ProxyInterval)
+	{
+		SimulateProxies(ProxyPendingTime);
+		ProxyPendingTime = 0.0f;
+	}
+
+	// Promote proxies a player came near
+	const float PromoteDistSq = FMath::Square(ProxyPromoteDistance);
+	int32 Promoted = 0;
+	for (int32 ProxyIndex = Proxies.Num() - 1; ProxyIndex >= 0 && Promoted < MaxProxyTransitionsPerFrame; --ProxyIndex)
+	{
+		if (GetNearestPlayerDistSquared(Proxies.Positions[ProxyIndex]) <= PromoteDistSq)
+		{
+			PromoteProxy(ProxyIndex);
+			++Promoted;
+		}
+	}
+}
+
+void URoamingAISubsystem::DemoteAgent(ARoamingAICharacter* Character)
+{
+	ARoamingAIController* Controller = Cast<ARoamingAIController>(Character->GetController());
+	if (!Controller || !Agents.Controllers.IsValidIndex(Controller->AgentIndex))
+		return;
+
+	const int32 Index = Controller->AgentIndex;
+	Proxies.Add(Character, Agents.States[Index], Agents.WaitTimers[Index]);
+
+	// Parking unregisters the agent, the actor and controller keep all their state
+	Character->EnterProxy();
+}
+
+void URoamingAISubsystem::PromoteProxy(int32 ProxyIndex)
+{
+	// Killed, destroyed or pooled while parked, nothing to bring back
+	ARoamingAICharacter* AIChar = Proxies.Characters[ProxyIndex];
+	if (!IsValid(AIChar) || !AIChar->IsProxy())
+	{
+		Proxies.RemoveAtSwap(ProxyIndex);
+		return;
+	}
+
+	// Proxy positions are navmesh path points or between them, lift to the capsule center
+	FVector Location = Proxies.Positions[ProxyIndex];
+	if (UNavigationSystemV1* NavSystem = UNavigationSystemV1::GetCurrent(GetWorld()))
+	{
+		FNavLocation Projected;
+		if (NavSystem->ProjectPointToNavigation(Location, Projected, FVector(200.0f, 200.0f, 500.0f)))
+		{
+			Location = Projected.Location;
+		}
+	}
+	Location.Z += AIChar->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+
+	AIChar->ExitProxy(Location, Proxies.Yaws[ProxyIndex]);
+	Proxies.RemoveAtSwap(ProxyIndex);
+}
+
+bool URoamingAISubsystem::PickProxyPath(int32 ProxyIndex, URoamPointPoolSubsystem* RoamPoints, UNavigationSystemV1* NavSystem)
+{
+	FVector Destination;
+	if (!RoamPoints || !NavSystem || !RoamPoints->GetRandomPoint(Proxies.RoamRegionIds[ProxyIndex], Destination))
+		return false;
+
+	const ARoamingAICharacter* AIChar = Proxies.Characters[ProxyIndex];
+	const FNavAgentProperties& AgentProps = AIChar->GetNavAgentPropertiesRef();
+	const FVector& Start = Proxies.Positions[ProxyIndex];
+	const ANavigationData* NavData = NavSystem->GetNavDataForProps(AgentProps, Start);
+	if (!NavData)
+		return false;
+
+	const FPathFindingResult Result = NavSystem->FindPathSync(AgentProps, FPathFindingQuery(AIChar, *NavData, Start, Destination));
+	if (!Result.IsSuccessful() || !Result.Path.IsValid() || Result.IsPartial())
+		return false;
+
+	TArray<FVector>& Points = Proxies.PathPoints[ProxyIndex];
+	Points.Reset();
+	for (const FNavPathPoint& PathPoint : Result.Path->GetPathPoints())
+	{
+		Points.Add(PathPoint.Location);
+	}
+	Proxies.NextPathPoints[ProxyIndex] = 0;
+	return Points.Num() > 0;
+}
+
+void URoamingAISubsystem::SimulateProxies(float DeltaTime)
+{
+	URoamPointPoolSubsystem* RoamPoints = UWorld::GetSubsystem<URoamPointPoolSubsystem>(GetWorld());
+	UNavigationSystemV1* NavSystem = UNavigationSystemV1::GetCurrent(GetWorld());
+	int32 PathBudget = MaxProxyPathsPerStep;
+
+	for (int32 ProxyIndex = Proxies.Num() - 1; ProxyIndex >= 0; --ProxyIndex)
+	{
+		const ARoamingAICharacter* AIChar = Proxies.Characters[ProxyIndex];
+		if (!IsValid(AIChar) || !AIChar->IsProxy())
+		{
+			Proxies.RemoveAtSwap(ProxyIndex);
+			continue;
+		}
+
+		if (Proxies.States[ProxyIndex] == EAIState::Waiting)
+		{
+			Proxies.WaitTimers[ProxyIndex] += DeltaTime;
+			if (Proxies.WaitTimers[ProxyIndex] < Proxies.RoamWaitTimes[ProxyIndex])
+				continue;
+
+			// Same as ResetToRoaming, the path is picked below
+			Proxies.States[ProxyIndex] = EAIState::Roaming;
+			Proxies.PathPoints[ProxyIndex].Reset();
+			Proxies.WaitTimers[ProxyIndex] = 0.0f;
+		}
+
+		TArray<FVector>& Points = Proxies.PathPoints[ProxyIndex];
+		if (Points.Num() == 0)
+		{
+			// Over budget or no path, wait a roam cycle and try again
+			if (PathBudget <= 0 || !PickProxyPath(ProxyIndex, RoamPoints, NavSystem))
+			{
+				Proxies.States[ProxyIndex] = EAIState::Waiting;
+				continue;
+			}
+			--PathBudget;
+		}
+
+		// Walk the path corners, carrying leftover distance over to the next one
+		FVector& Position = Proxies.Positions[ProxyIndex];
+		int32& NextPoint = Proxies.NextPathPoints[ProxyIndex];
+		float StepDistance = Proxies.RoamingSpeeds[ProxyIndex] * DeltaTime;
+		while (NextPoint < Points.Num())
+		{
+			const FVector ToPoint = Points[NextPoint] - Position;
+			const float PointDist = ToPoint.Size();
+			if (PointDist > StepDistance)
+			{
+				Position += ToPoint / PointDist * StepDistance;
+				Proxies.Yaws[ProxyIndex] = ToPoint.Rotation().Yaw;
+				break;
+			}
+
+			Position = Points[NextPoint];
+			StepDistance -= PointDist;
+			++NextPoint;
+		}
+
+		if (NextPoint >= Points.Num())
+		{
+			// Reached destination
+			Points.Reset();
+			Proxies.States[ProxyIndex] = EAIState::Waiting;
+			Proxies.WaitTimers[ProxyIndex] = 0.0f;
+		}
+	}
+}
+
+void URoamingAISubsystem::GatherPlayers()
+{
+	PlayerCharacters.Reset();
+	PlayerPositions.Reset();
+
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		APlayerController* PC = It->Get();
+		if (!PC)
+			continue;
+
+		ACharacter* PlayerChar = Cast<ACharacter>(PC->GetPawn());
+		if (!IsValid(PlayerChar))
+			continue;
+
+		PlayerCharacters.Add(PlayerChar);
+		PlayerPositions.Add(PlayerChar->GetActorLocation());
+	}
+}
+
+ERoamingAITickTier URoamingAISubsystem::ClassifyTier(int32 Index, float DistanceToPlayer) const
+{
+	// Chasers and agents that can see a player always run at full rate so reactions stay responsive
+	if (Agents.States[Index] == EAIState::Chasing || Agents.VisiblePlayers[Index] != INDEX_NONE ||
+		DistanceToPlayer <= NearTierDistance)
+		return ERoamingAITickTier::Near;
+
+	if (DistanceToPlayer <= MidTierDistance)
+		return ERoamingAITickTier::Mid;
+
+	return ERoamingAITickTier::Far;
+}
+
+void URoamingAISubsystem::UpdateFarAgents()
+{
+	const int32 NumAgents = Agents.Num();
+	if (NumAgents == 0 || FarAgentBudget <= 0)
+		return;
+
+	// Walk the agent list from where the last frame stopped, wrapping once
+	int32 Updated = 0;
+	int32 Visited = 0;
+	int32 Index = FarAgentCursor % NumAgents;
+	while (Visited < NumAgents && Updated < FarAgentBudget)
+	{
+		if (Agents.TickTiers[Index] == ERoamingAITickTier::Far)
+		{
+			UpdateAgent(Index);
+			++Updated;
+		}
+
+		Index = (Index + 1) % NumAgents;
+		++Visited;
+	}
+	FarAgentCursor = Index;
+}
+
+void URoamingAISubsystem::UpdateAgent(int32 Index)
+{
+	ARoamingAIController* Controller = Agents.Controllers[Index];
+	if (!Controller || !Agents.Characters[Index])
+		return;
+
+	// Consume all real time elapsed since this agent last updated so timers stay correct
+	const float DeltaTime = Agents.PendingDeltaTimes[Index];
+	Agents.PendingDeltaTimes[Index] = 0.0f;
+
+	// Controllers no longer tick themselves, keep control rotation in sync here
+	Controller->UpdateControlRotation(DeltaTime);
+
+	// Hidden until the respawn query teleports it
+	if (Agents.Respawning[Index])
+		return;
+
+	if (Agents.TargetPlayers[Index] == INDEX_NONE)
+		return; // No player found, skip this update
+
+	switch (Agents.States[Index])
+	{
+		case EAIState::Roaming:
+			RoamAgent(Index, DeltaTime);
+			break;
+
+		case EAIState::Chasing:
+			ChaseAgent(Index, DeltaTime);
+			break;
+
+		case EAIState::Waiting:
+			WaitAgent(Index, DeltaTime);
+			break;
+	}
+}
+
+void URoamingAISubsystem::HandleMoveCompleted(int32 AgentIndex, const FPathFollowingResult& Result)
+{
+	if (!Agents.States.IsValidIndex(AgentIndex))
+		return;
+
+	// Replaced by a newer path from an async query, not a real failure
+	if (Result.HasFlag(FPathFollowingResultFlags::NewRequest))
+		return;
+
+	// Only process if we're in roaming state
+	if (Agents.States[AgentIndex] != EAIState::Roaming)
+		return;
+
+	if (Result.IsSuccess())
+	{
+		// Successfully reached destination
+		Agents.ReachedDestination[AgentIndex] = true;
+		Agents.States[AgentIndex] = EAIState::Waiting;
+		Agents.WaitTimers[AgentIndex] = 0.0f;
+	}
+	else if (Result.IsFailure())
+	{
+		// Path failed or was blocked - get new destination
+		Agents.ReachedDestination[AgentIndex] = true;
+		Agents.RoamDestinations[AgentIndex] = FVector::ZeroVector;
+	}
+}
+
+void URoamingAISubsystem::StartChase(int32 Index)
+{
+	Agents.States[Index] = EAIState::Chasing;
+	++Agents.LoseSightSerials[Index]; // Drop any chase-lost deadline of an earlier chase
+	Agents.StuckTimers[Index] = 0.0f;
+	Agents.NextRepathTimes[Index] = 0.0; // Path toward the target straight away
+	Agents.PathQueryIds[Index] = 0; // Drop any roam path still in flight
+	Agents.FollowingFlowField[Index] = false;
+
+	// Increase speed for chasing
+	ARoamingAICharacter* AIChar = Agents.Characters[Index];
+	AIChar->GetCharacterMovement()->MaxWalkSpeed = AIChar->ChaseSpeed;
+}
+
+void URoamingAISubsystem::ResetToRoaming(int32 Index)
+{
+	Agents.States[Index] = EAIState::Roaming;
+	++Agents.LoseSightSerials[Index]; // Cancel any pending chase-lost deadline
+	Agents.WaitTimers[Index] = 0.0f;
+	Agents.StuckTimers[Index] = 0.0f;
+	Agents.PathQueryIds[Index] = 0; // Drop any chase path still in flight
+	Agents.FollowingFlowField[Index] = false;
+	Agents.ReachedDestination[Index] = true; // This will trigger getting a new roam location
+	Agents.RoamDestinations[Index] = FVector::ZeroVector; // Force new destination
+}
+
+bool URoamingAISubsystem::ShouldRepath(int32 Index, const FVector& GoalLocation, double Now) const
+{
+	if (Now < Agents.NextRepathTimes[Index])
+		return false;
+
+	// Nothing to follow, path right away
+	if (Agents.Controllers[Index]->GetMoveStatus() == EPathFollowingStatus::Idle)
+		return true;
+
+	// Refresh once the goal moved noticeably, or at the max interval regardless
+	return FVector::DistSquared(GoalLocation, Agents.RepathGoals[Index]) > FMath::Square(RepathGoalMoveThreshold) ||
+		Now - Agents.LastRepathTimes[Index] >= ChaseRepathMaxInterval;
+}
+
+void URoamingAISubsystem::ScheduleRepath(int32 Index, const FVector& GoalLocation, double Now)
+{
+	// Close targets need fresh paths more often than distant ones
+	const float DistanceAlpha = FMath::Clamp(Agents.TargetDistances[Index] / FMath::Max(ChaseRepathFarDistance, 1.0f), 0.0f, 1.0f);
+	float Interval = FMath::Lerp(ChaseRepathMinInterval, ChaseRepathMaxInterval, DistanceAlpha);
+
+	// Stretch by the agent's phase so chasers that started together drift apart
+	Interval *= 0.75f + 0.5f * Agents.RepathPhases[Index];
+
+	Agents.NextRepathTimes[Index] = Now + Interval;
+	Agents.LastRepathTimes[Index] = Now;
+	Agents.RepathGoals[Index] = GoalLocation;
+}
+
+bool URoamingAISubsystem::CanStartPathQuery() const
+{
+	return PathQueriesStartedThisFrame < MaxPathQueriesPerFrame && PathRequests.Num() < MaxPathQueriesInFlight;
+}
+
+bool URoamingAISubsystem::RequestAsyncMove(int32 Index, const FVector& GoalLocation, AActor* GoalActor, bool bProjectGoalLocation, int32 Retries)
+{
+	SCOPE_CYCLE_COUNTER(STAT_RoamingAIPath);
+	FScopedDurationTimer PathTimer(PerfCounters.PathSeconds);
+
+	ARoamingAIController* Controller = Agents.Controllers[Index];
+	ARoamingAICharacter* AIChar = Agents.Characters[Index];
+
+	UNavigationSystemV1* NavSystem = UNavigationSystemV1::GetCurrent(GetWorld());
+	if (!NavSystem)
+		return false;
+
+	FAIMoveRequest MoveRequest;
+	if (GoalActor)
+	{
+		MoveRequest.SetGoalActor(GoalActor);
+	}
+	else
+	{
+		MoveRequest.SetGoalLocation(GoalLocation);
+	}
+	MoveRequest.SetAcceptanceRadius(AIChar->AcceptanceRadius);
+	MoveRequest.SetReachTestIncludesAgentRadius(true); // bStopOnOverlap
+	MoveRequest.SetUsePathfinding(true);
+	MoveRequest.SetProjectGoalLocation(bProjectGoalLocation);
+	MoveRequest.SetCanStrafe(true);
+	MoveRequest.SetAllowPartialPath(true); // AI can get as close as possible even if full path fails
+
+	FPathFindingQuery Query;
+	if (!Controller->BuildPathfindingQuery(MoveRequest, Query))
+		return false;
+
+	const uint32 QueryId = NavSystem->FindPathAsync(
+		Controller->GetNavAgentPropertiesRef(),
+		Query,
+		FNavPathQueryDelegate::CreateUObject(this, &URoamingAISubsystem::OnPathQueryFinished),
+		EPathFindingMode::Regular
+	);
+	if (QueryId == 0)
+		return false;
+
+	FRoamingAIPathRequest& Request = PathRequests.Add(QueryId);
+	Request.Controller = Controller;
+	Request.MoveRequest = MoveRequest;
+	Request.State = Agents.States[Index];
+	Request.GoalLocation = GoalLocation;
+	Request.GoalActor = GoalActor;
+	Request.bProjectGoalLocation = bProjectGoalLocation;
+	Request.Deadline = GetWorld()->GetTimeSeconds() + PathQueryTimeout;
+	Request.Retries = Retries;
+
+	// A newer query supersedes any older one still in flight for this agent
+	Agents.PathQueryIds[Index] = QueryId;
+	++PathQueriesStartedThisFrame;
+	++PerfCounters.PathQueries;
+	return true;
+}
+
+void URoamingAISubsystem::OnPathQueryFinished(uint32 QueryId, ENavigationQueryResult::Type Result, FNavPathSharedPtr Path)
+{
+	SCOPE_CYCLE_COUNTER(STAT_RoamingAIPath);
+	FScopedDurationTimer PathTimer(PerfCounters.PathSeconds);
+
+	FRoamingAIPathRequest Request;
+	if (!PathRequests.RemoveAndCopyValue(QueryId, Request))
+		return;
+
+	ARoamingAIController* Controller = Request.Controller.Get();
+	if (!Controller || !Agents.Controllers.IsValidIndex(Controller->AgentIndex))
+		return;
+
+	// Ignore results the agent no longer wants
+	const int32 Index = Controller->AgentIndex;
+	if (Agents.PathQueryIds[Index] != QueryId || Agents.States[Index] != Request.State)
+		return;
+	Agents.PathQueryIds[Index] = 0;
+
+	FAIRequestID MoveId = FAIRequestID::InvalidRequest;
+	if (Result == ENavigationQueryResult::Success && Path.IsValid())
+	{
+		MoveId = Controller->RequestMove(Request.MoveRequest, Path);
+	}
+
+	if (!MoveId.IsValid() && Request.State == EAIState::Roaming)
+	{
+		// Path completely failed, pick another destination on the next update
+		Agents.RoamDestinations[Index] = FVector::ZeroVector;
+		Agents.ReachedDestination[Index] = true;
+	}
+}
+
+void URoamingAISubsystem::ExpirePathQueries(double Now)
+{
+	if (PathQueryTimeout <= 0.0f || PathRequests.Num() == 0)
+		return;
+
+	ExpiredPathQueryScratch.Reset();
+	for (const TPair<uint32, FRoamingAIPathRequest>& Pair : PathRequests)
+	{
+		if (Pair.Value.Deadline <= Now)
+		{
+			ExpiredPathQueryScratch.Add(Pair.Key);
+		}
+	}
+
+	UNavigationSystemV1* NavSystem = UNavigationSystemV1::GetCurrent(GetWorld());
+	for (uint32 QueryId : ExpiredPathQueryScratch)
+	{
+		FRoamingAIPathRequest Request;
+		PathRequests.RemoveAndCopyValue(QueryId, Request);
+		++PerfCounters.PathTimeouts;
+
+		// A result that still turns up is ignored, its request is gone
+		if (NavSystem)
+		{
+			NavSystem->AbortAsyncFindPathRequest(QueryId);
+		}
+
+		ARoamingAIController* Controller = Request.Controller.Get();
+		if (!Controller || !Agents.Controllers.IsValidIndex(Controller->AgentIndex))
+			continue;
+
+		const int32 Index = Controller->AgentIndex;
+		if (Agents.PathQueryIds[Index] != QueryId)
+			continue;
+		Agents.PathQueryIds[Index] = 0;
+
+		if (Agents.States[Index] != Request.State)
+			continue;
+
+		// Reissue from the shared budget, a lost goal actor falls back to its last location
+		if (Request.Retries < MaxPathQueryRetries && CanStartPathQuery() &&
+			RequestAsyncMove(Index, Request.GoalLocation, Request.GoalActor.Get(), Request.bProjectGoalLocation, Request.Retries + 1))
+			continue;
+
+		if (Request.State == EAIState::Roaming)
+		{
+			// Pick another destination on the next update
+			Agents.RoamDestinations[Index] = FVector::ZeroVector;
+			Agents.ReachedDestination[Index] = true;
+		}
+		else
+		{
+			// Chasers refresh their path on the next update
+			Agents.NextRepathTimes[Index] = 0.0;
+		}
+	}
+}
+
+bool URoamingAISubsystem::UpdateStuckTimer(int32 Index, const FVector& GoalLocation, float DeltaTime)
+{
+	ARoamingAICharacter* AIChar = Agents.Characters[Index];
+	float& StuckTimer = Agents.StuckTimers[Index];
+
+	// Detect if AI is stuck (not moving but far from destination)
+	const float DistanceToGoal = FVector::Dist(Agents.Positions[Index], GoalLocation);
+	if (AIChar->GetVelocity().Size2D() < 10.0f && DistanceToGoal > AIChar->AcceptanceRadius * 1.5f)
+	{
+		StuckTimer += DeltaTime;
+		if (StuckTimer > 2.0f) // Stuck for 2 seconds
+		{
+			StuckTimer = 0.0f;
+			return true;
+		}
+	}
+	else
+	{
+		StuckTimer = 0.0f; // Reset stuck timer if moving
+	}
+	return false;
+}
+
+void URoamingAISubsystem::RoamAgent(int32 Index, float DeltaTime)
+{
+	ARoamingAIController* Controller = Agents.Controllers[Index];
+	ARoamingAICharacter* AIChar = Agents.Characters[Index];
+
+	// Spotting a player is handled by the SightGained stimulus
+
+	// Set roaming speed
+	AIChar->GetCharacterMovement()->MaxWalkSpeed = AIChar->RoamingSpeed;
+
+	FVector& RoamDestination = Agents.RoamDestinations[Index];
+
+	// Check if we need a new destination
+	if (Agents.ReachedDestination[Index] || RoamDestination == FVector::ZeroVector)
+	{
+		// Out of path query budget this frame, try again on the next update
+		if (!CanStartPathQuery())
+			return;
+
+		// Get new random location to roam to
+		FVector NewDestination = GetRandomRoamLocation(Index);
+		if (NewDestination != FVector::ZeroVector)
+		{
+			// The move starts once the async path arrives, failures are handled in OnPathQueryFinished
+			if (RequestAsyncMove(Index, NewDestination, nullptr, false)) // Roam points already lie on the navmesh
+			{
+				RoamDestination = NewDestination;
+				Agents.ReachedDestination[Index] = false;
+			}
+			else
+			{
+				// Path completely failed, try again on the next update
+				RoamDestination = FVector::ZeroVector;
+				Agents.ReachedDestination[Index] = true;
+			}
+		}
+		else
+		{
+			// Navigation system failed to find any valid location, wait and retry
+			Agents.States[Index] = EAIState::Waiting;
+			Agents.WaitTimers[Index] = 0.0f;
+			Controller->StopMovement();
+		}
+	}
+	else
+	{
+		// Currently moving to destination - give it up if stuck
+		if (UpdateStuckTimer(Index, RoamDestination, DeltaTime))
+		{
+			Agents.ReachedDestination[Index] = true;
+			RoamDestination = FVector::ZeroVector;
+			Controller->StopMovement();
+		}
+	}
+}
+
+void URoamingAISubsystem::ChaseAgent(int32 Index, float DeltaTime)
+{
+	ARoamingAICharacter* AIChar = Agents.Characters[Index];
+	ACharacter* Target = PlayerCharacters[Agents.TargetPlayers[Index]];
+	if (!IsValid(Target))
+		return;
+
+	// Set chase speed
+	AIChar->GetCharacterMovement()->MaxWalkSpeed = AIChar->ChaseSpeed;
+
+	// Check if we're close enough to attack
+	const FVector& TargetLocation = PlayerPositions[Agents.TargetPlayers[Index]];
+	const float DistanceToPlayer = Agents.TargetDistances[Index];
+	if (DistanceToPlayer <= AIChar->AttackRange && AIChar->CanAttack())
+	{
+		// Attack the player!
+		if (AIChar->TryAttackPlayer(Target))
+		{
+			// Attack successful - AI has respawned, reset to roaming
+			ResetToRoaming(Index);
+			return;
+		}
+	}
+
+	const double Now = GetWorld()->GetTimeSeconds();
+
+	// A stuck chaser refreshes its path on the next update instead of waiting for its slot
+	if (UpdateStuckTimer(Index, TargetLocation, DeltaTime))
+	{
+		Agents.NextRepathTimes[Index] = 0.0;
+		Agents.RepathGoals[Index] = FVector(MAX_FLT);
+
+		// The field's straight cell steps can snag on geometry, path around it for a while
+		if (Agents.FollowingFlowField[Index])
+		{
+			Agents.FlowFieldRetryTimes[Index] = Now + 2.0;
+		}
+	}
+
+	// Losing the player is handled by the SightLost stimulus and its chase-lost deadline
+	if (CanSeeTarget(Index))
+	{
+		// Move towards player along the shared flow field, or refresh our own path on this agent's schedule
+		if (!FollowChaseFlowField(Index, Now) &&
+			Agents.PathQueryIds[Index] == 0 && ShouldRepath(Index, TargetLocation, Now) &&
+			CanStartPathQuery() && RequestAsyncMove(Index, TargetLocation, Target, true))
+		{
+			ScheduleRepath(Index, TargetLocation, Now);
+		}
+	}
+	else
+	{
+		// Keep moving to last known position
+		if (!FollowChaseFlowField(Index, Now) &&
+			Agents.PathQueryIds[Index] == 0 && ShouldRepath(Index, TargetLocation, Now) &&
+			CanStartPathQuery() && RequestAsyncMove(Index, TargetLocation, nullptr, true))
+		{
+			ScheduleRepath(Index, TargetLocation, Now);
+		}
+	}
+}
+
+void URoamingAISubsystem::WaitAgent(int32 Index, float DeltaTime)
+{
+	ARoamingAICharacter* AIChar = Agents.Characters[Index];
+
+	// Increment wait timer
+	Agents.WaitTimers[Index] += DeltaTime;
+
+	// Check if wait time is over
+	if (Agents.WaitTimers[Index] >= AIChar->RoamWaitTime)
+	{
+		ResetToRoaming(Index);
+	}
+}
+
+bool URoamingAISubsystem::CanSeeTarget(int32 Index) const
+{
+	// TargetPlayers already prefers the visible player when there is one
+	const int32 VisiblePlayer = Agents.VisiblePlayers[Index];
+	return VisiblePlayer != INDEX_NONE && VisiblePlayer == Agents.TargetPlayers[Index];
+}
+
+FVector URoamingAISubsystem::GetRandomRoamLocation(int32 Index) const
+{
+	ARoamingAICharacter* AIChar = Agents.Characters[Index];
+
+	// Pre-validated point from the spawn region's pool
+	FVector PooledLocation;
+	if (AIChar->GetRandomPooledRoamPoint(PooledLocation))
+		return PooledLocation;
+
+	UNavigationSystemV1* NavSystem = UNavigationSystemV1::GetCurrent(GetWorld());
+	if (!NavSystem)
+		return FVector::ZeroVector;
+
+	// Pool not filled yet, try to get random point within roaming distance from spawn location
+	FNavLocation ResultLocation;
+
+	// Try multiple times if first attempt fails
+	const int32 MaxAttempts = 3;
+	for (int32 Attempt = 0; Attempt < MaxAttempts; ++Attempt)
+	{
+		if (NavSystem->GetRandomPointInNavigableRadius(AIChar->GetSpawnLocation(), AIChar->MaxRoamDistance, ResultLocation))
+		{
+			return ResultLocation.Location;
+		}
+	}
+
+	// If all attempts failed, try getting a point from current location instead
+	if (NavSystem->GetRandomPointInNavigableRadius(
+		Agents.Positions[Index],
+		AIChar->MaxRoamDistance * 0.5f, // Use smaller radius from current position
+		ResultLocation))
+	{
+		return ResultLocation.Location;
+	}
+
+	return FVector::ZeroVector;
+}
+
+int32 URoamingAISubsystem::FindClosestPlayer(int32 Index, float& OutDistance) const
+{
+	OutDistance = MAX_FLT;
+	return PlayerGrid.FindNearest(Agents.Positions[Index], MAX_FLT, &OutDistance);
+}
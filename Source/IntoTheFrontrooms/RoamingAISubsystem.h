@@ -0,0 +1,787 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WorldCollision.h"
+#include "SpatialHashGrid.h"
+#include "ChaseFlowField.h"
+#include "UObject/ObjectKey.h"
+#include "AITypes.h"
+#include "NavigationData.h"
+#include "RoamingAIController.h"
+#include "RoamingAISubsystem.generated.h"
+
+class ACharacter;
+class ARoamingAICharacter;
+struct FPathFollowingResult;
+
+// Update frequency tier, chosen from distance to the nearest player
+UENUM(BlueprintType)
+enum class ERoamingAITickTier : uint8
+{
+	Near	UMETA(DisplayName = "Near"),	// Updated every AI step
+	Mid		UMETA(DisplayName = "Mid"),		// Updated at MidTierUpdateRate
+	Far		UMETA(DisplayName = "Far")		// Updated round-robin within FarAgentBudget
+};
+
+/**
+ * Struct-of-arrays storage for every registered roaming agent.
+ * Index N in each array always refers to the same agent.
+ */
+USTRUCT()
+struct FRoamingAIAgentArrays
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<TObjectPtr<ARoamingAIController>> Controllers;
+
+	UPROPERTY()
+	TArray<TObjectPtr<ARoamingAICharacter>> Characters;
+
+	// Pawn location, refreshed once per frame before decisions run
+	TArray<FVector> Positions;
+
+	TArray<EAIState> States;
+
+	// Time spent waiting at the current roam destination
+	TArray<float> WaitTimers;
+
+	// Player the agent had line of sight to last frame, SightGained/SightLost are raised when it changes
+	TArray<TWeakObjectPtr<ACharacter>> SeenPlayers;
+
+	// Bumped to cancel the agent's pending chase-lost deadline
+	TArray<uint32> LoseSightSerials;
+
+	// Index into the subsystem's player list, INDEX_NONE when no player is available
+	TArray<int32> TargetPlayers;
+
+	// Distance to the target player, computed once per frame
+	TArray<float> TargetDistances;
+
+	TArray<FVector> RoamDestinations;
+
+	TArray<bool> ReachedDestination;
+
+	// Time spent barely moving while far from the move goal
+	TArray<float> StuckTimers;
+
+	// Earliest world time the agent may refresh its chase path
+	TArray<double> NextRepathTimes;
+
+	// World time and goal of the last chase path refresh
+	TArray<double> LastRepathTimes;
+	TArray<FVector> RepathGoals;
+
+	// Random 0-1 phase that spreads path refreshes of different agents across frames
+	TArray<float> RepathPhases;
+
+	// Async path query in flight for the agent, 0 when none
+	TArray<uint32> PathQueryIds;
+
+	// Closest player with a clear line of sight in last frame's async traces, INDEX_NONE if none
+	TArray<int32> VisiblePlayers;
+
+	TArray<ERoamingAITickTier> TickTiers;
+
+	// Real time elapsed since the agent's last update, consumed when it next updates
+	TArray<float> PendingDeltaTimes;
+
+	// Hidden while a respawn query picks a new site, skips updates until it completes
+	TArray<bool> Respawning;
+
+	// Chasing along the target's shared flow field instead of an own path
+	TArray<bool> FollowingFlowField;
+
+	// World time before which the agent uses its own path, set after getting stuck on the field
+	TArray<double> FlowFieldRetryTimes;
+
+	// Direction picked from the flow field on the last step, applied as movement input every frame
+	TArray<FVector> FlowFieldDirections;
+
+	// Avoidance quality applied to the agent's crowd following component, INDEX_NONE while not crowd simulated
+	TArray<int8> CrowdQualities;
+
+	int32 Num() const { return Controllers.Num(); }
+
+	/** Append a new agent with default state, returns its index */
+	int32 Add(ARoamingAIController* Controller, ARoamingAICharacter* Character);
+
+	/** Remove an agent, moving the last agent into its slot */
+	void RemoveAtSwap(int32 Index);
+};
+
+/** An async sight trace queued for one (agent, player) pair */
+struct FRoamingAISightTrace
+{
+	FTraceHandle Handle;
+	uint64 CacheKey;
+};
+
+/**
+ * Struct-of-arrays storage for roaming enemies far from every player whose actors are
+ * parked (see ARoamingAICharacter::EnterProxy) and simulated here instead.
+ * Index N in each array always refers to the same proxy.
+ */
+USTRUCT()
+struct FRoamingAIProxyArrays
+{
+	GENERATED_BODY()
+
+	// Parked actor, moved to the proxy's location on promotion
+	UPROPERTY()
+	TArray<TObjectPtr<ARoamingAICharacter>> Characters;
+
+	// Feet location on the navmesh path being followed
+	TArray<FVector> Positions;
+
+	TArray<float> Yaws;
+
+	// Roam point pool region of the spawn location
+	TArray<int32> RoamRegionIds;
+
+	// Roaming or Waiting, proxies are promoted long before they could chase
+	TArray<EAIState> States;
+
+	// Navmesh path points to the roam destination, empty while none is picked
+	TArray<TArray<FVector>> PathPoints;
+
+	// Next point of PathPoints to walk to
+	TArray<int32> NextPathPoints;
+
+	TArray<float> WaitTimers;
+
+	// Tunables copied from the actor so the proxy step doesn't touch actor memory
+	TArray<float> RoamingSpeeds;
+	TArray<float> RoamWaitTimes;
+
+	int32 Num() const { return Characters.Num(); }
+
+	/** Record a proxy for an enemy about to be parked, returns its index */
+	int32 Add(ARoamingAICharacter* Character, EAIState State, float WaitTimer);
+
+	/** Remove a proxy, moving the last proxy into its slot */
+	void RemoveAtSwap(int32 Index);
+};
+
+/** An async visibility trace from one player's eye to one respawn candidate */
+struct FRoamingAIRespawnTrace
+{
+	int32 Candidate = INDEX_NONE;
+	FVector Start = FVector::ZeroVector;
+	FVector End = FVector::ZeroVector;
+	FTraceHandle Handle;
+};
+
+/** A respawn site search spread over several frames */
+struct FRoamingAIRespawnQuery
+{
+	TWeakObjectPtr<ARoamingAICharacter> Character;
+
+	// Candidate sites and their scores (distance to the nearest player, -1 once rejected)
+	TArray<FVector> Candidates;
+	TArray<float> Scores;
+
+	// Traces still needed to prove candidates are out of every player's view
+	TArray<FRoamingAIRespawnTrace> Traces;
+
+	// Traces before NextTrace have been issued, traces before ConsumedTraces have been read back
+	int32 NextTrace = 0;
+	int32 ConsumedTraces = 0;
+
+	bool bCandidatesGathered = false;
+};
+
+/** Flow fields toward one chased player, one in use while the next is built around the player's new position */
+struct FRoamingAIChaseFieldState
+{
+	FChaseFlowField Fields[2];
+	int32 ActiveField = 0;
+
+	// World time the player last had enough chasers to need the field
+	double LastUsedTime = 0.0;
+};
+
+/** A player inside an agent's sight radius, tracked to raise enter/leave events */
+struct FRoamingAISightRadiusPair
+{
+	TWeakObjectPtr<ARoamingAIController> Controller;
+	TWeakObjectPtr<ACharacter> Player;
+
+	// Perception frame the pair was last found in range, 0 for a new pair
+	uint32 LastFrame = 0;
+};
+
+/** When a chaser that lost sight of its target gives up */
+struct FRoamingAIChaseDeadline
+{
+	double Time;
+	TWeakObjectPtr<ARoamingAIController> Controller;
+
+	// Agent's LoseSightSerials value when scheduled, the deadline is void once it changed
+	uint32 Serial;
+
+	bool operator<(const FRoamingAIChaseDeadline& Other) const { return Time < Other.Time; }
+};
+
+/** A move waiting for its async path query to finish */
+struct FRoamingAIPathRequest
+{
+	TWeakObjectPtr<ARoamingAIController> Controller;
+	FAIMoveRequest MoveRequest;
+
+	// State the move was requested for, results arriving after a state change are dropped
+	EAIState State;
+
+	// Goal the query was started for, so a timed out query can be reissued
+	FVector GoalLocation;
+	TWeakObjectPtr<AActor> GoalActor;
+	bool bProjectGoalLocation;
+
+	// World time after which the query is given up, and how often it was reissued already
+	double Deadline;
+	int32 Retries;
+};
+
+/** Last line of sight result for one (agent, player) pair */
+struct FRoamingAISightCacheEntry
+{
+	// Eye positions the cached result was traced from/to
+	FVector AgentEye = FVector::ZeroVector;
+	FVector PlayerEye = FVector::ZeroVector;
+
+	// World time the result was traced
+	double ResultTime = -1.0;
+
+	// World time the entry was last looked up, used to evict unused pairs
+	double LastUsedTime = 0.0;
+
+	bool bVisible = false;
+	bool bHasResult = false;
+	bool bTracePending = false;
+};
+
+/** Line of sight counters, for checking how many physics queries the cache saves */
+USTRUCT(BlueprintType)
+struct FRoamingAISightStats
+{
+	GENERATED_BODY()
+
+	/** Pairs answered from the cache without a trace */
+	UPROPERTY(BlueprintReadOnly, Category = "AI|Sight")
+	int32 CacheHits = 0;
+
+	/** Pairs that needed a new trace */
+	UPROPERTY(BlueprintReadOnly, Category = "AI|Sight")
+	int32 CacheMisses = 0;
+
+	/** Pairs rejected by the view cone or eye height gate before any trace */
+	UPROPERTY(BlueprintReadOnly, Category = "AI|Sight")
+	int32 GateRejections = 0;
+
+	/** Async traces actually issued */
+	UPROPERTY(BlueprintReadOnly, Category = "AI|Sight")
+	int32 TracesIssued = 0;
+
+	/** Traces avoided by cache hits and gate rejections */
+	UPROPERTY(BlueprintReadOnly, Category = "AI|Sight")
+	int32 TracesSaved = 0;
+
+	void Accumulate(const FRoamingAISightStats& Other)
+	{
+		CacheHits += Other.CacheHits;
+		CacheMisses += Other.CacheMisses;
+		GateRejections += Other.GateRejections;
+		TracesIssued += Other.TracesIssued;
+		TracesSaved += Other.TracesSaved;
+	}
+};
+
+/** Cumulative time spent in each part of the AI update, for profiling and the AI benchmark */
+USTRUCT(BlueprintType)
+struct FRoamingAIPerfCounters
+{
+	GENERATED_BODY()
+
+	/** Whole subsystem tick, includes sight and respawn work (seconds) */
+	UPROPERTY(BlueprintReadOnly, Category = "AI|Profiling")
+	double UpdateSeconds = 0.0;
+
+	/** Sight cache lookups and trace readback (seconds) */
+	UPROPERTY(BlueprintReadOnly, Category = "AI|Profiling")
+	double SightSeconds = 0.0;
+
+	/** Async path query requests and result handling (seconds) */
+	UPROPERTY(BlueprintReadOnly, Category = "AI|Profiling")
+	double PathSeconds = 0.0;
+
+	/** Respawn site searches (seconds) */
+	UPROPERTY(BlueprintReadOnly, Category = "AI|Profiling")
+	double RespawnSeconds = 0.0;
+
+	/** Fixed AI steps simulated */
+	UPROPERTY(BlueprintReadOnly, Category = "AI|Profiling")
+	int32 Steps = 0;
+
+	/** Async path queries started */
+	UPROPERTY(BlueprintReadOnly, Category = "AI|Profiling")
+	int32 PathQueries = 0;
+
+	/** Respawn site searches started */
+	UPROPERTY(BlueprintReadOnly, Category = "AI|Profiling")
+	int32 RespawnQueries = 0;
+
+	/** Async path queries given up because their result never arrived */
+	UPROPERTY(BlueprintReadOnly, Category = "AI|Profiling")
+	int32 PathTimeouts = 0;
+};
+
+/**
+ * World subsystem that owns every roaming enemy and runs their
+ * roam/chase/wait decisions in a single batched pass per frame.
+ * Controllers register themselves on possession and no longer tick on their own.
+ * Agents far from every player are updated less often (see the LOD settings).
+ */
+UCLASS(config=Game)
+class INTOTHEFRONTROOMS_API URoamingAISubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	URoamingAISubsystem();
+
+	// USubsystem interface
+	virtual void Deinitialize() override;
+
+	// FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/** Add a controller/pawn pair to the batched update. Returns the agent index. */
+	int32 RegisterAgent(ARoamingAIController* Controller, ARoamingAICharacter* Character);
+
+	/** Remove a controller from the batched update */
+	void UnregisterAgent(ARoamingAIController* Controller);
+
+	/** Current behavior state of an agent */
+	EAIState GetAgentState(int32 AgentIndex) const;
+
+	/** Forwarded from the controller when a move request finishes */
+	void HandleMoveCompleted(int32 AgentIndex, const FPathFollowingResult& Result);
+
+	/** Start an off-screen respawn site search for a hidden character, it is teleported once a site is chosen */
+	void RequestRespawn(ARoamingAICharacter* Character);
+
+	/** Number of registered agents */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "AI")
+	int32 GetNumAgents() const { return Agents.Num(); }
+
+	// Simulation Settings (Config/DefaultGame.ini)
+
+	/** AI decision steps per second, independent of frame rate. 0 runs one variable step per frame. */
+	UPROPERTY(Config, BlueprintReadOnly, Category = "AI|Simulation")
+	float FixedStepHz;
+
+	/** Maximum decision steps run in one frame, extra time is dropped after a hitch */
+	UPROPERTY(Config, BlueprintReadOnly, Category = "AI|Simulation")
+	int32 MaxStepsPerFrame;
+
+	// LOD Settings
+
+	/** Agents closer than this to a player update every step */
+	UPROPERTY(Config, BlueprintReadOnly, Category = "AI|LOD")
+	float NearTierDistance;
+
+	/** Agents closer than this (but beyond NearTierDistance) update at MidTierUpdateRate */
+	UPROPERTY(Config, BlueprintReadOnly, Category = "AI|LOD")
+	float MidTierDistance;
+
+	/** Updates per second for mid range agents */
+	UPROPERTY(Config, BlueprintReadOnly, Category = "AI|LOD")
+	float MidTierUpdateRate;
+
+	/** Maximum number of far agents updated per step, shared round-robin */
+	UPROPERTY(Config, BlueprintReadOnly, Category = "AI|LOD")
+	int32 FarAgentBudget;
+
+	/** A cached sight result is re-traced once either eye moved farther than this */
+	UPROPERTY(Config, BlueprintReadOnly, Category = "AI|Sight")
+	float SightCacheMoveThreshold;
+
+	/** A cached sight result is re-traced once it is older than this (seconds) */
+	UPROPERTY(Config, BlueprintReadOnly, Category = "AI|Sight")
+	float SightCacheLifetime;
+
+	/** Sight counters since the last reset */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "AI|Sight")
+	FRoamingAISightStats GetSightStats() const { return TotalSightStats; }
+
+	/** Sight counters for the last frame only */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "AI|Sight")
+	FRoamingAISightStats GetLastFrameSightStats() const { return FrameSightStats; }
+
+	/** Clear the accumulated sight counters */
+	UFUNCTION(BlueprintCallable, Category = "AI|Sight")
+	void ResetSightStats() { TotalSightStats = FRoamingAISightStats(); }
+
+	/** Time spent in the AI update since the last reset */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "AI|Profiling")
+	FRoamingAIPerfCounters GetPerfCounters() const { return PerfCounters; }
+
+	/** Clear the accumulated perf counters */
+	UFUNCTION(BlueprintCallable, Category = "AI|Profiling")
+	void ResetPerfCounters() { PerfCounters = FRoamingAIPerfCounters(); }
+
+	/** Shortest chase path refresh interval, used when the target is close (seconds) */
+	UPROPERTY(Config, BlueprintReadOnly, Category = "AI|Pathing")
+	float ChaseRepathMinInterval;
+
+	/** Longest chase path refresh interval, used at ChaseRepathFarDistance and beyond (seconds) */
+	UPROPERTY(Config, BlueprintReadOnly, Category = "AI|Pathing")
+	float ChaseRepathMaxInterval;
+
+	/** Target distance at which chase paths refresh at ChaseRepathMaxInterval */
+	UPROPERTY(Config, BlueprintReadOnly, Category = "AI|Pathing")
+	float ChaseRepathFarDistance;
+
+	/** Before ChaseRepathMaxInterval, a path is only refreshed once its goal moved farther than this */
+	UPROPERTY(Config, BlueprintReadOnly, Category = "AI|Pathing")
+	float RepathGoalMoveThreshold;
+
+	/** Maximum number of async path queries started per AI step */
+	UPROPERTY(Config, BlueprintReadOnly, Category = "AI|Pathing")
+	int32 MaxPathQueriesPerFrame;
+
+	/** Maximum number of async path queries in flight at once */
+	UPROPERTY(Config, BlueprintReadOnly, Category = "AI|Pathing")
+	int32 MaxPathQueriesInFlight;
+
+	/** Seconds an async path query may stay in flight before it is given up, e.g. after a navmesh rebuild lost it */
+	UPROPERTY(Config, BlueprintReadOnly, Category = "AI|Pathing")
+	float PathQueryTimeout;
+
+	/** Times a timed out path query is reissued (within the per-frame budget) before the agent picks a new move */
+	UPROPERTY(Config, BlueprintReadOnly, Category = "AI|Pathing")
+	int32 MaxPathQueryRetries;
+
+	/** Number of async path queries currently in flight */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "AI|Pathing")
+	int32 GetNumPathQueriesInFlight() const { return PathRequests.Num(); }
+
+	/** Chase along shared navmesh flow fields when several enemies target the same player */
+	UPROPERTY(Config, BlueprintReadOnly, Category = "AI|Flow Field")
+	bool bUseChaseFlowFields;
+
+	/** Chasers a player needs before a flow field is built toward them */
+	UPROPERTY(Config, BlueprintReadOnly, Category = "AI|Flow Field")
+	int32 ChaseFlowFieldMinChasers;
+
+	/** Half size of the square area a flow field covers around its player */
+	UPROPERTY(Config, BlueprintReadOnly, Category = "AI|Flow Field")
+	float ChaseFlowFieldRadius;
+
+	/** Flow field cell size */
+	UPROPERTY(Config, BlueprintReadOnly, Category = "AI|Flow Field")
+	float ChaseFlowFieldCellSize;
+
+	/** Neighbouring cells further apart in height than this are not linked */
+	UPROPERTY(Config, BlueprintReadOnly, Category = "AI|Flow Field")
+	float ChaseFlowFieldMaxStepHeight;
+
+	/** Flow field cells projected or linked per frame, shared by all fields being built */
+	UPROPERTY(Config, BlueprintReadOnly, Category = "AI|Flow Field")
+	int32 ChaseFlowFieldBuildCellsPerFrame;
+
+	/** Crowd-following agents nearest to their target that are simulated by the Detour crowd, keep within CrowdManager MaxAgents */
+	UPROPERTY(Config, BlueprintReadOnly, Category = "AI|Crowd")
+	int32 CrowdAgentBudget;
+
+	/** Nearest crowd agents that get high avoidance quality, the rest of the budget use medium */
+	UPROPERTY(Config, BlueprintReadOnly, Category = "AI|Crowd")
+	int32 CrowdHighQualityAgents;
+
+	/** Seconds between crowd budget re-assignments */
+	UPROPERTY(Config, BlueprintReadOnly, Category = "AI|Crowd")
+	float CrowdBudgetUpdateInterval;
+
+	/** Park roaming enemies far from every player (those with bAllowProxyRepresentation) and simulate them as proxies */
+	UPROPERTY(Config, BlueprintReadOnly, Category = "AI|Proxy")
+	bool bUseProxyAgents;
+
+	/** Roaming enemies farther than this from every player become proxies */
+	UPROPERTY(Config, BlueprintReadOnly, Category = "AI|Proxy")
+	float ProxyDemoteDistance;
+
+	/** Proxies closer than this to a player are brought back as actors, keep below ProxyDemoteDistance */
+	UPROPERTY(Config, BlueprintReadOnly, Category = "AI|Proxy")
+	float ProxyPromoteDistance;
+
+	/** Proxy simulation steps per second */
+	UPROPERTY(Config, BlueprintReadOnly, Category = "AI|Proxy")
+	float ProxyUpdateRate;
+
+	/** Maximum demotions and promotions each per frame, spreads the parking cost */
+	UPROPERTY(Config, BlueprintReadOnly, Category = "AI|Proxy")
+	int32 MaxProxyTransitionsPerFrame;
+
+	/** Maximum navmesh paths computed for proxies per proxy step, the rest keep waiting until the next one */
+	UPROPERTY(Config, BlueprintReadOnly, Category = "AI|Proxy")
+	int32 MaxProxyPathsPerStep;
+
+	/** Number of enemies currently simulated as proxies */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "AI|Proxy")
+	int32 GetNumProxies() const { return Proxies.Num(); }
+
+	/** Candidate sites scored per respawn query */
+	UPROPERTY(Config, BlueprintReadOnly, Category = "AI|Respawn")
+	int32 RespawnCandidates;
+
+	/** Maximum number of respawn visibility traces issued per frame, shared by all queries */
+	UPROPERTY(Config, BlueprintReadOnly, Category = "AI|Respawn")
+	int32 RespawnTracesPerFrame;
+
+	/** Candidates closer than this to any player are rejected without a trace */
+	UPROPERTY(Config, BlueprintReadOnly, Category = "AI|Respawn")
+	float RespawnMinPlayerDistance;
+
+	/** Candidates outside this half angle of a player's view are treated as off-screen without a trace (degrees) */
+	UPROPERTY(Config, BlueprintReadOnly, Category = "AI|Respawn")
+	float RespawnViewHalfAngle;
+
+	/** Cell size of the player and agent spatial hash grids */
+	UPROPERTY(Config, BlueprintReadOnly, Category = "AI|Spatial")
+	float SpatialGridCellSize;
+
+	// Proximity Queries (valid after the subsystem has ticked this frame)
+
+	/** Players within Radius of Location */
+	UFUNCTION(BlueprintCallable, Category = "AI|Spatial")
+	void QueryPlayersInRadius(const FVector& Location, float Radius, TArray<ACharacter*>& OutPlayers) const;
+
+	/** Up to Count players closest to Location, nearest first */
+	UFUNCTION(BlueprintCallable, Category = "AI|Spatial")
+	void QueryNearestPlayers(const FVector& Location, int32 Count, TArray<ACharacter*>& OutPlayers) const;
+
+	/** Players within the agent's SightRange */
+	UFUNCTION(BlueprintCallable, Category = "AI|Spatial")
+	void QueryPlayersInSightRange(const ARoamingAICharacter* Agent, TArray<ACharacter*>& OutPlayers) const;
+
+	/** Roaming enemies within Radius of Location */
+	UFUNCTION(BlueprintCallable, Category = "AI|Spatial")
+	void QueryAgentsInRadius(const FVector& Location, float Radius, TArray<ARoamingAICharacter*>& OutAgents) const;
+
+	/** Spatial index of this frame's players, ids are indices into the player list */
+	const FSpatialHashGrid& GetPlayerGrid() const { return PlayerGrid; }
+
+	/** Spatial index of registered agents, ids are agent indices */
+	const FSpatialHashGrid& GetAgentGrid() const { return AgentGrid; }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	// One fixed AI step: players, proxies, grids, perception and agent decisions
+	void SimulateStep(float DeltaTime);
+
+	// Build the player list for this step
+	void GatherPlayers();
+
+	// Rebuild the player and agent grids from this frame's positions
+	void RebuildSpatialGrids();
+
+	// Drop agents that unregistered while the batch was running
+	void FlushPendingRemovals();
+
+	// Read back the sight traces queued last frame into the sight cache
+	void ConsumeSightTraces();
+
+	// Resolve VisiblePlayers for agents with a player in their sight radius from the sight cache,
+	// queueing async traces only for pairs whose cached result is missing or stale.
+	// Raises SightGained/SightLost where the seen player changed.
+	void UpdateSight();
+
+	// Find (agent, player) pairs within sight range from each player's side and raise enter/leave events
+	void UpdateSightRadiusPairs();
+
+	// React to a perception event and forward it to the controller's OnStimulus
+	void RaiseStimulus(int32 Index, ERoamingAIStimulus Stimulus, ACharacter* Player);
+
+	// Return chasers whose chase-lost deadline passed without regaining sight to roaming
+	void ProcessChaseDeadlines(double Now);
+
+	// Drop cache entries for pairs that have not been looked up recently
+	void EvictSightCache(double Now);
+
+	static uint64 MakeSightCacheKey(const ARoamingAIController* Controller, const ACharacter* Player)
+	{
+		return (uint64(Controller->GetUniqueID()) << 32) | uint64(Player->GetUniqueID());
+	}
+
+	// Advance every respawn query by one step: gather candidates, read back traces, issue traces, commit
+	void UpdateRespawnQueries();
+
+	// Fill a query with scored candidates and the traces needed to check them, false if there are none
+	bool GatherRespawnCandidates(FRoamingAIRespawnQuery& Query);
+
+	// Teleport the character to the best candidate and hand it back to the batched update
+	void CompleteRespawnQuery(FRoamingAIRespawnQuery& Query);
+
+	// Build, swap and re-integrate the flow fields of players with enough chasers
+	void UpdateChaseFlowFields();
+
+	// Steer a chaser along its target's flow field, false if it should use its own path instead
+	bool FollowChaseFlowField(int32 Index, double Now);
+
+	// Hand the crowd simulation and avoidance quality budget to the crowd agents nearest their targets
+	void UpdateCrowdBudget();
+
+	// Demote far agents to proxies, simulate proxies and promote the ones a player came near
+	void UpdateProxies(float DeltaTime);
+
+	// Park an agent's actor and simulate it as a proxy
+	void DemoteAgent(ARoamingAICharacter* Character);
+
+	// Bring a proxy's actor back at the proxy's location
+	void PromoteProxy(int32 ProxyIndex);
+
+	// Find a navmesh path for a proxy to a new roam point, false if none could be found
+	bool PickProxyPath(int32 ProxyIndex, URoamPointPoolSubsystem* RoamPoints, UNavigationSystemV1* NavSystem);
+
+	// Advance the roam/wait logic of every proxy by DeltaTime
+	void SimulateProxies(float DeltaTime);
+
+	// Squared distance from Location to the nearest player, MAX_FLT without players
+	float GetNearestPlayerDistSquared(const FVector& Location) const;
+
+	// Pick the update tier for an agent from its distance to the nearest player
+	ERoamingAITickTier ClassifyTier(int32 Index, float DistanceToPlayer) const;
+
+	// Update far agents round-robin until the per-frame budget is spent
+	void UpdateFarAgents();
+
+	// AI Behavior Functions
+	void UpdateAgent(int32 Index);
+	void RoamAgent(int32 Index, float DeltaTime);
+	void ChaseAgent(int32 Index, float DeltaTime);
+	void WaitAgent(int32 Index, float DeltaTime);
+
+	// Switch an agent into chase mode
+	void StartChase(int32 Index);
+
+	// True if the agent's chase path is due for a refresh toward GoalLocation
+	bool ShouldRepath(int32 Index, const FVector& GoalLocation, double Now) const;
+
+	// Record a path refresh and schedule the next one from distance and the agent's phase
+	void ScheduleRepath(int32 Index, const FVector& GoalLocation, double Now);
+
+	// True if another async path query may start this frame
+	bool CanStartPathQuery() const;
+
+	// Start an async path query, the move begins when the path arrives.
+	// The agent keeps following its current path meanwhile.
+	bool RequestAsyncMove(int32 Index, const FVector& GoalLocation, AActor* GoalActor, bool bProjectGoalLocation, int32 Retries = 0);
+
+	// Give up path queries past their deadline, reissuing them while retries and budget remain
+	void ExpirePathQueries(double Now);
+
+	// Start the move for a finished async path query
+	void OnPathQueryFinished(uint32 QueryId, ENavigationQueryResult::Type Result, FNavPathSharedPtr Path);
+
+	// Accumulate stuck time, returns true once the agent has been stuck long enough to give up its move
+	bool UpdateStuckTimer(int32 Index, const FVector& GoalLocation, float DeltaTime);
+
+	// Reset an agent back to roaming with a fresh destination
+	void ResetToRoaming(int32 Index);
+
+	// Line of Sight Check, uses last frame's async trace results
+	bool CanSeeTarget(int32 Index) const;
+
+	// Get random location for roaming
+	FVector GetRandomRoamLocation(int32 Index) const;
+
+	// Find the closest player from this frame's player list
+	int32 FindClosestPlayer(int32 Index, float& OutDistance) const;
+
+protected:
+	UPROPERTY()
+	FRoamingAIAgentArrays Agents;
+
+	// Player pawns gathered once per frame
+	UPROPERTY()
+	TArray<TObjectPtr<ACharacter>> PlayerCharacters;
+
+	// Player locations matching PlayerCharacters
+	TArray<FVector> PlayerPositions;
+
+	FSpatialHashGrid PlayerGrid;
+	FSpatialHashGrid AgentGrid;
+
+	// Reused query result buffer
+	mutable TArray<int32> QueryScratch;
+
+	// Async path queries in flight, by query id
+	TMap<uint32, FRoamingAIPathRequest> PathRequests;
+
+	// Reused buffer of timed out query ids
+	TArray<uint32> ExpiredPathQueryScratch;
+
+	int32 PathQueriesStartedThisFrame = 0;
+
+	// Real time not yet simulated in fixed steps
+	float StepAccumulator = 0.0f;
+
+	// Sight traces queued this frame, consumed next frame
+	TArray<FRoamingAISightTrace> SightTraces;
+
+	// Last line of sight result per (agent, player) pair
+	TMap<uint64, FRoamingAISightCacheEntry> SightCache;
+
+	FRoamingAISightStats FrameSightStats;
+	FRoamingAISightStats TotalSightStats;
+
+	FRoamingAIPerfCounters PerfCounters;
+
+	// Chasing agents per player this frame, matching PlayerCharacters
+	TArray<int32> PlayerChaserCounts;
+
+	// Flow fields of chased players
+	TMap<TObjectKey<ACharacter>, FRoamingAIChaseFieldState> ChaseFields;
+
+	// Built flow field per player this frame, null when the player has none
+	TArray<const FChaseFlowField*> PlayerFlowFields;
+
+	// World time of the next crowd budget re-assignment
+	double NextCrowdBudgetTime = 0.0;
+
+	UPROPERTY()
+	FRoamingAIProxyArrays Proxies;
+
+	// Real time not yet simulated for proxies
+	float ProxyPendingTime = 0.0f;
+
+	// Respawn site searches in progress
+	TArray<FRoamingAIRespawnQuery> RespawnQueries;
+
+	// Agent/player pairs within sight range, by sight cache key
+	TMap<uint64, FRoamingAISightRadiusPair> SightRadiusPairs;
+
+	// This frame's pairs within sight range as (agent, player), grouped by agent
+	TArray<FIntPoint> SightPairs;
+
+	uint32 PerceptionFrame = 0;
+
+	// Largest SightRange of any agent, radius of the per-player reverse query
+	float MaxAgentSightRange = 0.0f;
+
+	// Pending chase-lost deadlines, min-heap on Time
+	TArray<FRoamingAIChaseDeadline> ChaseDeadlines;
+
+	// Agents removed while the batch was running, removed once it finishes
+	TArray<int32> PendingRemovals;
+
+	bool bUpdatingAgents = false;
+
+	// Agent index the next far tier round-robin pass starts from
+	int32 FarAgentCursor = 0;
+};
@@ -0,0 +1,254 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SpatialHashGrid.h"
+
+FSpatialHashGrid::FSpatialHashGrid(float InCellSize)
+	: MinCell(0, 0)
+	, MaxCell(-1, -1)
+{
+	SetCellSize(InCellSize);
+}
+
+void FSpatialHashGrid::SetCellSize(float InCellSize)
+{
+	CellSize = FMath::Max(InCellSize, 1.0f);
+	InvCellSize = 1.0f / CellSize;
+}
+
+void FSpatialHashGrid::Reset()
+{
+	Entries.Reset();
+	CellRanges.Reset();
+	MinCell = FIntPoint(0, 0);
+	MaxCell = FIntPoint(-1, -1);
+}
+
+void FSpatialHashGrid::Add(int32 Id, const FVector& Location)
+{
+	Entries.Add({ 0, Id, Location });
+}
+
+FIntPoint FSpatialHashGrid::GetCell(const FVector& Location) const
+{
+	return FIntPoint(
+		FMath::FloorToInt32(Location.X * InvCellSize),
+		FMath::FloorToInt32(Location.Y * InvCellSize));
+}
+
+void FSpatialHashGrid::Build()
+{
+	CellRanges.Reset();
+	if (Entries.Num() == 0)
+	{
+		MinCell = FIntPoint(0, 0);
+		MaxCell = FIntPoint(-1, -1);
+		return;
+	}
+
+	MinCell = FIntPoint(MAX_int32, MAX_int32);
+	MaxCell = FIntPoint(MIN_int32, MIN_int32);
+	for (FEntry& Entry : Entries)
+	{
+		const FIntPoint Cell = GetCell(Entry.Location);
+		Entry.CellKey = MakeKey(Cell);
+		MinCell = FIntPoint(FMath::Min(MinCell.X, Cell.X), FMath::Min(MinCell.Y, Cell.Y));
+		MaxCell = FIntPoint(FMath::Max(MaxCell.X, Cell.X), FMath::Max(MaxCell.Y, Cell.Y));
+	}
+
+	// Group entries by cell so each cell is one contiguous range
+	Entries.Sort([](const FEntry& A, const FEntry& B) { return A.CellKey < B.CellKey; });
+
+	int32 RangeStart = 0;
+	for (int32 Index = 1; Index <= Entries.Num(); ++Index)
+	{
+		if (Index == Entries.Num() || Entries[Index].CellKey != Entries[RangeStart].CellKey)
+		{
+			CellRanges.Add(Entries[RangeStart].CellKey, TPair<int32, int32>(RangeStart, Index - RangeStart));
+			RangeStart = Index;
+		}
+	}
+}
+
+void FSpatialHashGrid::QueryRadius(const FVector& Center, float Radius, TArray<int32>& OutIds) const
+{
+	if (Entries.Num() == 0)
+		return;
+
+	const FIntPoint Lo = GetCell(Center - FVector(Radius, Radius, 0.0f));
+	const FIntPoint Hi = GetCell(Center + FVector(Radius, Radius, 0.0f));
+	const float RadiusSq = FMath::Square(Radius);
+
+	for (int32 X = FMath::Max(Lo.X, MinCell.X); X <= FMath::Min(Hi.X, MaxCell.X); ++X)
+	{
+		for (int32 Y = FMath::Max(Lo.Y, MinCell.Y); Y <= FMath::Min(Hi.Y, MaxCell.Y); ++Y)
+		{
+			ForEachInCell(FIntPoint(X, Y), [&](const FEntry& Entry)
+			{
+				if (FVector::DistSquared(Center, Entry.Location) <= RadiusSq)
+				{
+					OutIds.Add(Entry.Id);
+				}
+			});
+		}
+	}
+}
+
+bool FSpatialHashGrid::AnyInRadius(const FVector& Center, float Radius) const
+{
+	if (Entries.Num() == 0)
+		return false;
+
+	const FIntPoint Lo = GetCell(Center - FVector(Radius, Radius, 0.0f));
+	const FIntPoint Hi = GetCell(Center + FVector(Radius, Radius, 0.0f));
+	const float RadiusSq = FMath::Square(Radius);
+
+	for (int32 X = FMath::Max(Lo.X, MinCell.X); X <= FMath::Min(Hi.X, MaxCell.X); ++X)
+	{
+		for (int32 Y = FMath::Max(Lo.Y, MinCell.Y); Y <= FMath::Min(Hi.Y, MaxCell.Y); ++Y)
+		{
+			if (const TPair<int32, int32>* Range = CellRanges.Find(MakeKey(FIntPoint(X, Y))))
+			{
+				for (int32 Index = Range->Key; Index < Range->Key + Range->Value; ++Index)
+				{
+					if (FVector::DistSquared(Center, Entries[Index].Location) <= RadiusSq)
+						return true;
+				}
+			}
+		}
+	}
+	return false;
+}
+
+void FSpatialHashGrid::GetRingRange(const FIntPoint& CenterCell, int32& OutFirstRing, int32& OutLastRing) const
+{
+	// Chebyshev distance from the center cell to the nearest and farthest occupied cell bounds
+	const int32 DX = FMath::Max3(MinCell.X - CenterCell.X, 0, CenterCell.X - MaxCell.X);
+	const int32 DY = FMath::Max3(MinCell.Y - CenterCell.Y, 0, CenterCell.Y - MaxCell.Y);
+	OutFirstRing = FMath::Max(DX, DY);
+	OutLastRing = FMath::Max(
+		FMath::Max(FMath::Abs(CenterCell.X - MinCell.X), FMath::Abs(MaxCell.X - CenterCell.X)),
+		FMath::Max(FMath::Abs(CenterCell.Y - MinCell.Y), FMath::Abs(MaxCell.Y - CenterCell.Y)));
+}
+
+void FSpatialHashGrid::VisitRing(const FIntPoint& CenterCell, int32 Ring, TFunctionRef<void(const FEntry&)> Func) const
+{
+	if (Ring == 0)
+	{
+		ForEachInCell(CenterCell, Func);
+		return;
+	}
+
+	// Top and bottom rows, clamped to the occupied bounds
+	const int32 XLo = FMath::Max(CenterCell.X - Ring, MinCell.X);
+	const int32 XHi = FMath::Min(CenterCell.X + Ring, MaxCell.X);
+	for (const int32 Y : { CenterCell.Y - Ring, CenterCell.Y + Ring })
+	{
+		if (Y < MinCell.Y || Y > MaxCell.Y)
+			continue;
+
+		for (int32 X = XLo; X <= XHi; ++X)
+		{
+			ForEachInCell(FIntPoint(X, Y), Func);
+		}
+	}
+
+	// Left and right columns, excluding the corners already visited
+	const int32 YLo = FMath::Max(CenterCell.Y - Ring + 1, MinCell.Y);
+	const int32 YHi = FMath::Min(CenterCell.Y + Ring - 1, MaxCell.Y);
+	for (const int32 X : { CenterCell.X - Ring, CenterCell.X + Ring })
+	{
+		if (X < MinCell.X || X > MaxCell.X)
+			continue;
+
+		for (int32 Y = YLo; Y <= YHi; ++Y)
+		{
+			ForEachInCell(FIntPoint(X, Y), Func);
+		}
+	}
+}
+
+void FSpatialHashGrid::QueryNearest(const FVector& Center, int32 Count, TArray<int32>& OutIds, float MaxRadius) const
+{
+	OutIds.Reset();
+	if (Count <= 0 || Entries.Num() == 0)
+		return;
+
+	const float MaxRadiusSq = MaxRadius < MAX_FLT ? FMath::Square(MaxRadius) : MAX_FLT;
+
+	// Best candidates so far as (distance squared, id), nearest first
+	TArray<TPair<float, int32>, TInlineAllocator<16>> Best;
+
+	const FIntPoint CenterCell = GetCell(Center);
+	int32 FirstRing, LastRing;
+	GetRingRange(CenterCell, FirstRing, LastRing);
+
+	for (int32 Ring = FirstRing; Ring <= LastRing; ++Ring)
+	{
+		// Anything in this ring is at least (Ring - 1) cells away from Center
+		const float RingMinDistSq = FMath::Square(FMath::Max(Ring - 1, 0) * CellSize);
+		if (RingMinDistSq > MaxRadiusSq)
+			break;
+		if (Best.Num() == Count && Best.Last().Key <= RingMinDistSq)
+			break;
+
+		VisitRing(CenterCell, Ring, [&](const FEntry& Entry)
+		{
+			const float DistSq = FVector::DistSquared(Center, Entry.Location);
+			if (DistSq > MaxRadiusSq || (Best.Num() == Count && DistSq >= Best.Last().Key))
+				return;
+
+			int32 InsertAt = Best.Num();
+			while (InsertAt > 0 && Best[InsertAt - 1].Key > DistSq)
+			{
+				--InsertAt;
+			}
+			Best.Insert(TPair<float, int32>(DistSq, Entry.Id), InsertAt);
+			if (Best.Num() > Count)
+			{
+				Best.Pop(EAllowShrinking::No);
+			}
+		});
+	}
+
+	for (const TPair<float, int32>& Candidate : Best)
+	{
+		OutIds.Add(Candidate.Value);
+	}
+}
+
+int32 FSpatialHashGrid::FindNearest(const FVector& Center, float MaxRadius, float* OutDistance) const
+{
+	if (Entries.Num() == 0)
+		return INDEX_NONE;
+
+	float BestDistSq = MaxRadius < MAX_FLT ? FMath::Square(MaxRadius) : MAX_FLT;
+	int32 BestId = INDEX_NONE;
+
+	const FIntPoint CenterCell = GetCell(Center);
+	int32 FirstRing, LastRing;
+	GetRingRange(CenterCell, FirstRing, LastRing);
+
+	for (int32 Ring = FirstRing; Ring <= LastRing; ++Ring)
+	{
+		// Stop once no cell in this ring can beat the current best
+		const float RingMinDistSq = FMath::Square(FMath::Max(Ring - 1, 0) * CellSize);
+		if (RingMinDistSq > BestDistSq)
+			break;
+
+		VisitRing(CenterCell, Ring, [&](const FEntry& Entry)
+		{
+			const float DistSq = FVector::DistSquared(Center, Entry.Location);
+			if (DistSq < BestDistSq || (BestId == INDEX_NONE && DistSq <= BestDistSq))
+			{
+				BestDistSq = DistSq;
+				BestId = Entry.Id;
+			}
+		});
+	}
+
+	if (OutDistance && BestId != INDEX_NONE)
+	{
+		*OutDistance = FMath::Sqrt(BestDistSq);
+	}
+	return BestId;
+}
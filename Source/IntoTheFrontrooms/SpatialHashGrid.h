@@ -0,0 +1,92 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Uniform spatial hash over the XY plane, rebuilt once per frame.
+ * Items are identified by an index owned by the caller (e.g. an agent or player slot).
+ * Usage: Reset(), Add() every item, Build(), then query.
+ */
+class INTOTHEFRONTROOMS_API FSpatialHashGrid
+{
+public:
+	explicit FSpatialHashGrid(float InCellSize = 2000.0f);
+
+	/** Change the cell size, takes effect on the next Build() */
+	void SetCellSize(float InCellSize);
+
+	float GetCellSize() const { return CellSize; }
+
+	/** Remove all items, keeping allocations */
+	void Reset();
+
+	/** Add an item, call Build() once all items are added */
+	void Add(int32 Id, const FVector& Location);
+
+	/** Sort items into cells so they can be queried */
+	void Build();
+
+	/** Number of indexed items */
+	int32 Num() const { return Entries.Num(); }
+
+	/** Append every item within Radius of Center to OutIds (unordered) */
+	void QueryRadius(const FVector& Center, float Radius, TArray<int32>& OutIds) const;
+
+	/** Fill OutIds with up to Count items closest to Center, nearest first */
+	void QueryNearest(const FVector& Center, int32 Count, TArray<int32>& OutIds, float MaxRadius = MAX_FLT) const;
+
+	/** Closest item to Center, INDEX_NONE if there is none within MaxRadius */
+	int32 FindNearest(const FVector& Center, float MaxRadius = MAX_FLT, float* OutDistance = nullptr) const;
+
+	/** True if any item lies within Radius of Center */
+	bool AnyInRadius(const FVector& Center, float Radius) const;
+
+private:
+	struct FEntry
+	{
+		uint64 CellKey;
+		int32 Id;
+		FVector Location;
+	};
+
+	FIntPoint GetCell(const FVector& Location) const;
+
+	static uint64 MakeKey(const FIntPoint& Cell)
+	{
+		return (uint64(uint32(Cell.X)) << 32) | uint64(uint32(Cell.Y));
+	}
+
+	// Calls Func(const FEntry&) for every item in a cell
+	template<typename FuncType>
+	void ForEachInCell(const FIntPoint& Cell, FuncType&& Func) const
+	{
+		if (const TPair<int32, int32>* Range = CellRanges.Find(MakeKey(Cell)))
+		{
+			for (int32 Index = Range->Key; Index < Range->Key + Range->Value; ++Index)
+			{
+				Func(Entries[Index]);
+			}
+		}
+	}
+
+	// Calls Func for every item in the cells at Chebyshev distance Ring from CenterCell
+	void VisitRing(const FIntPoint& CenterCell, int32 Ring, TFunctionRef<void(const FEntry&)> Func) const;
+
+	// First and last ring around CenterCell that can contain occupied cells
+	void GetRingRange(const FIntPoint& CenterCell, int32& OutFirstRing, int32& OutLastRing) const;
+
+	float CellSize;
+	float InvCellSize;
+
+	// Items sorted by cell after Build()
+	TArray<FEntry> Entries;
+
+	// Cell key -> (first entry, entry count)
+	TMap<uint64, TPair<int32, int32>> CellRanges;
+
+	// Occupied cell bounds, used to stop ring searches
+	FIntPoint MinCell;
+	FIntPoint MaxCell;
+};